@@ -12,28 +12,62 @@
 #define _FileSistemConfig_h_
 
 /**
- * @brief The path to the file that contains the session data.
+ * @brief The path to the text file of session data written before the device configuration.
  */
 #define SESSION_FILE "/cache/session.txt"
 
 /**
- * @brief The path to the file that contains the self data.
+ * @brief The path to the text file of self data written before the device configuration.
  */
 #define SELF_FILE "/cache/self.txt"
 
 /**
- * @brief The path to the file that contains the entry data.
+ * @brief The path to the text file of entry data written before the device configuration.
  */
 #define ENTRY_FILE "/cache/entry.txt"
 
 /**
- * @brief The path to the file that contains the typing data.
+ * @brief The path to the text file of typing data written before the device configuration.
  */
 #define TYPING_FILE "/cache/typing.txt"
 
 /**
- * @brief The path to the file that contains the measure data.
+ * @brief The path to the device configuration record.
+ */
+#define DEVICE_CONFIG_FILE "/cache/config.bin"
+
+/**
+ * @brief The path to the text file of measures written before the measure log.
  */
 #define MEASURE_FILE "/cache/measure.txt"
 
+/**
+ * @brief The directory of the segments of the measure log.
+ */
+#define MEASURE_LOG_DIR "/log"
+
+/**
+ * @brief The path to the file that holds the last acknowledged position of the measure log.
+ */
+#define MEASURE_LOG_ACK_FILE "/log/ack"
+
+/**
+ * @brief Suffix of the temporary file a file is written to before replacing it.
+ */
+#define FILE_TEMP_SUFFIX ".tmp"
+
+/**
+ * @brief Number of files kept open by the handle cache.
+ */
+#ifndef FILE_HANDLE_CACHE_SIZE
+#define FILE_HANDLE_CACHE_SIZE 4
+#endif // ! FILE_HANDLE_CACHE_SIZE
+
+/**
+ * @brief Size, in bytes, of the block files are read in, and the longest line read at once.
+ */
+#ifndef FILE_READ_BUFFER_SIZE
+#define FILE_READ_BUFFER_SIZE 256
+#endif // ! FILE_READ_BUFFER_SIZE
+
 #endif // ! _FileSistemConfig_h_
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * @file measure.h
+ * @brief Measure configuration
+ * @details This file contains the configuration of the measures read from the soil sensor.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MeasureConfig_h_
+#define _MeasureConfig_h_
+
+/**
+ * @brief Interval, in milliseconds, between two readings of the sensor after boot.
+ */
+#ifndef MEASURE_INTERVAL_MS
+#define MEASURE_INTERVAL_MS 60000
+#endif // ! MEASURE_INTERVAL_MS
+
+/**
+ * @brief Shortest interval, in milliseconds, used while the soil values are moving.
+ */
+#ifndef MEASURE_MIN_INTERVAL_MS
+#define MEASURE_MIN_INTERVAL_MS 15000
+#endif // ! MEASURE_MIN_INTERVAL_MS
+
+/**
+ * @brief Longest interval, in milliseconds, reached while the soil values are flat.
+ */
+#ifndef MEASURE_MAX_INTERVAL_MS
+#define MEASURE_MAX_INTERVAL_MS 900000
+#endif // ! MEASURE_MAX_INTERVAL_MS
+
+/**
+ * @brief Growth, in percent, of the interval after a measure without changes.
+ */
+#ifndef MEASURE_BACKOFF_PERCENT
+#define MEASURE_BACKOFF_PERCENT 150
+#endif // ! MEASURE_BACKOFF_PERCENT
+
+/**
+ * @brief Number of sensor readings averaged into a single measure.
+ */
+#ifndef MEASURE_OVERSAMPLING
+#define MEASURE_OVERSAMPLING 4
+#endif // ! MEASURE_OVERSAMPLING
+
+/**
+ * @brief Number of readings of the median filter that rejects spikes. 1 disables it.
+ */
+#ifndef MEASURE_MEDIAN_WINDOW
+#define MEASURE_MEDIAN_WINDOW 3
+#endif // ! MEASURE_MEDIAN_WINDOW
+
+/**
+ * @brief Weight, out of 256, of a new measure on the exponential moving average. 256 disables it.
+ */
+#ifndef MEASURE_EMA_ALPHA
+#define MEASURE_EMA_ALPHA 64
+#endif // ! MEASURE_EMA_ALPHA
+
+/**
+ * @brief Size, in bytes, a segment of the measure log grows up to. One flash block by default.
+ */
+#ifndef MEASURE_LOG_SEGMENT_SIZE
+#define MEASURE_LOG_SEGMENT_SIZE 4096
+#endif // ! MEASURE_LOG_SEGMENT_SIZE
+
+/**
+ * @brief Largest number of segments of the measure log. The oldest one is dropped beyond it,
+ * acknowledged or not.
+ */
+#ifndef MEASURE_LOG_MAX_SEGMENTS
+#define MEASURE_LOG_MAX_SEGMENTS 16
+#endif // ! MEASURE_LOG_MAX_SEGMENTS
+
+/**
+ * @brief The measure log keeps its segments as files of LittleFS.
+ */
+#define MEASURE_STORAGE_LITTLEFS 0
+
+/**
+ * @brief The measure log keeps its segments on a ring of raw flash sectors, one per segment.
+ * Requires MEASURE_FLASH_START.
+ */
+#define MEASURE_STORAGE_FLASH_RING 1
+
+/**
+ * @brief Storage of the segments of the measure log.
+ * @details The flash ring skips the metadata and the block allocation of LittleFS, for nodes
+ * saving measures at a high rate.
+ */
+#ifndef MEASURE_STORAGE
+#define MEASURE_STORAGE MEASURE_STORAGE_LITTLEFS
+#endif // ! MEASURE_STORAGE
+
+/*
+ * MEASURE_FLASH_START: address of the MEASURE_LOG_MAX_SEGMENTS flash sectors of the flash
+ * ring, sector aligned. It has no default: the region must be kept out of the sketch, OTA
+ * and file system areas by the linker script of the board.
+ */
+
+/**
+ * @brief First 4-byte block of the RTC user memory used by the measure buffer. The first 32
+ * blocks, 128 bytes, hold the OTA command of eboot.
+ */
+#ifndef MEASURE_RTC_OFFSET
+#define MEASURE_RTC_OFFSET 32
+#endif // ! MEASURE_RTC_OFFSET
+
+/**
+ * @brief Size, in bytes, of the RTC user memory given to the measure buffer, the rest of it by
+ * default.
+ */
+#ifndef MEASURE_RTC_SIZE
+#define MEASURE_RTC_SIZE 384
+#endif // ! MEASURE_RTC_SIZE
+
+/**
+ * @brief Longest time, in seconds, a measure waits in RTC memory before being flushed.
+ */
+#ifndef MEASURE_RTC_FLUSH_S
+#define MEASURE_RTC_FLUSH_S 3600
+#endif // ! MEASURE_RTC_FLUSH_S
+
+#endif // ! _MeasureConfig_h_
@@ -0,0 +1,145 @@
+/**
+ * @file modbus.h
+ * @brief Modbus configuration
+ * @details This file contains the configuration of the Modbus RTU link with the soil sensor.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusConfig_h_
+#define _ModbusConfig_h_
+
+/**
+ * @brief Address of the primary soil sensor on the RS485 bus.
+ */
+#ifndef MODBUS_SLAVE_ADDRESS
+#define MODBUS_SLAVE_ADDRESS 0x01
+#endif // ! MODBUS_SLAVE_ADDRESS
+
+/**
+ * @brief Addresses of every probe on the RS485 bus, comma separated, in polling order.
+ * @details e.g. -D MODBUS_SLAVE_ADDRESSES="0x01,0x02,0x03" for probes at several depths.
+ */
+#ifndef MODBUS_SLAVE_ADDRESSES
+#define MODBUS_SLAVE_ADDRESSES MODBUS_SLAVE_ADDRESS
+#endif // ! MODBUS_SLAVE_ADDRESSES
+
+/**
+ * @brief Number of consecutive failed readings after which a probe is considered dead.
+ */
+#ifndef MODBUS_SLAVE_DEAD_AFTER
+#define MODBUS_SLAVE_DEAD_AFTER 3
+#endif // ! MODBUS_SLAVE_DEAD_AFTER
+
+/**
+ * @brief Largest number of rounds a dead probe is skipped. Doubled from 1 on each failure.
+ */
+#ifndef MODBUS_SLAVE_BACKOFF_MAX_ROUNDS
+#define MODBUS_SLAVE_BACKOFF_MAX_ROUNDS 32
+#endif // ! MODBUS_SLAVE_BACKOFF_MAX_ROUNDS
+
+/**
+ * @brief Baud rate of the RS485 bus.
+ */
+#ifndef MODBUS_BAUD_RATE
+#define MODBUS_BAUD_RATE 4800
+#endif // ! MODBUS_BAUD_RATE
+
+/**
+ * @brief Time, in milliseconds, the sensor has to answer a request.
+ */
+#ifndef MODBUS_RESPONSE_TIMEOUT_MS
+#define MODBUS_RESPONSE_TIMEOUT_MS 200
+#endif // ! MODBUS_RESPONSE_TIMEOUT_MS
+
+/**
+ * @brief Number of times a failed request is repeated before giving up.
+ */
+#ifndef MODBUS_MAX_RETRIES
+#define MODBUS_MAX_RETRIES 2
+#endif // ! MODBUS_MAX_RETRIES
+
+/**
+ * @brief Wait, in milliseconds, before the first retry. Doubled on each retry.
+ */
+#ifndef MODBUS_RETRY_BACKOFF_MS
+#define MODBUS_RETRY_BACKOFF_MS 50
+#endif // ! MODBUS_RETRY_BACKOFF_MS
+
+/**
+ * @brief Longest wait, in milliseconds, between two retries.
+ */
+#ifndef MODBUS_RETRY_BACKOFF_MAX_MS
+#define MODBUS_RETRY_BACKOFF_MAX_MS 400
+#endif // ! MODBUS_RETRY_BACKOFF_MAX_MS
+
+/**
+ * @brief Largest number of registers requested in a single read.
+ */
+#ifndef MODBUS_MAX_REGISTERS_PER_READ
+#define MODBUS_MAX_REGISTERS_PER_READ 16
+#endif // ! MODBUS_MAX_REGISTERS_PER_READ
+
+/**
+ * @brief Largest hole, in registers, merged into a single read.
+ * @details Reading an unused register costs 2 bytes on the bus, a new transaction costs
+ * a full request, response and turnaround.
+ */
+#ifndef MODBUS_MAX_REGISTER_GAP
+#define MODBUS_MAX_REGISTER_GAP 2
+#endif // ! MODBUS_MAX_REGISTER_GAP
+
+/**
+ * @brief Bit-banged serial on RS485_RX_PIN and RS485_TX_PIN.
+ */
+#define RS485_TRANSPORT_SOFTWARE_SERIAL 0
+
+/**
+ * @brief UART0 swapped to GPIO13 (RX) and GPIO15 (TX). Requires -D DEBUG_SERIAL=Serial1.
+ */
+#define RS485_TRANSPORT_UART0 1
+
+/**
+ * @brief Transport of the RS485 bus.
+ * @details The hardware UART holds higher baud rates without framing errors while the WiFi
+ * is busy, and costs no CPU time per bit.
+ */
+#ifndef RS485_TRANSPORT
+#define RS485_TRANSPORT RS485_TRANSPORT_SOFTWARE_SERIAL
+#endif // ! RS485_TRANSPORT
+
+/**
+ * @brief RS485 receiver enable pin, D1 on the NodeMCU.
+ */
+#ifndef RS485_RE_PIN
+#define RS485_RE_PIN 5
+#endif // ! RS485_RE_PIN
+
+/**
+ * @brief RS485 driver enable pin, D2 on the NodeMCU.
+ */
+#ifndef RS485_DE_PIN
+#define RS485_DE_PIN 4
+#endif // ! RS485_DE_PIN
+
+// GPIO6 to GPIO11 are wired to the SPI flash, driving them hangs or resets the node.
+static_assert(!(RS485_RE_PIN >= 6 && RS485_RE_PIN <= 11), "RS485_RE_PIN must not be a pin of the SPI flash");
+static_assert(!(RS485_DE_PIN >= 6 && RS485_DE_PIN <= 11), "RS485_DE_PIN must not be a pin of the SPI flash");
+
+/**
+ * @brief RS485 receive pin of the software serial transport.
+ */
+#ifndef RS485_RX_PIN
+#define RS485_RX_PIN 2
+#endif // ! RS485_RX_PIN
+
+/**
+ * @brief RS485 transmit pin of the software serial transport.
+ */
+#ifndef RS485_TX_PIN
+#define RS485_TX_PIN 3
+#endif // ! RS485_TX_PIN
+
+#endif // ! _ModbusConfig_h_
@@ -16,4 +16,11 @@
 */
 #define USE_BUILTIN_LED
 
+/**
+ * @brief Size, in bytes, of the arena the broker messages are handled on.
+ */
+#ifndef MESSAGE_ARENA_SIZE
+#define MESSAGE_ARENA_SIZE 1024
+#endif // ! MESSAGE_ARENA_SIZE
+
 #endif // ! _SystemConfig_h_
\ No newline at end of file
@@ -1,13 +1,35 @@
-//
-// Created by higor on 21/07/2023.
-//
+/**
+ * @file data-frame.h
+ * @brief Request frames of the soil sensor.
+ * @details The requests are built at runtime by ModbusBuildRequest, for the address of each
+ * slave. This file checks the builder against the frames of the sensor datasheet at compile time.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-21
+ *
+ */
 
 #ifndef NATURART_FIRMWARE_DATA_FRAME_H
 #define NATURART_FIRMWARE_DATA_FRAME_H
 
-#include <Arduino.h>
-#include <c_types.h>
+#include <modbus-frame.h>
+#include <modbus-register-map.h>
 
-constexpr uint8_t WATER[] = {0x01, 0x03, 0x02, 0x01, 0x00, 0x01, 0xE4, 0x0C};
+// Reference frames of the sensor datasheet, for slave 0x01.
+static_assert(ModbusFrame<0x01, 0x03, 0x0200, 1>::value.equals({0x01, 0x03, 0x02, 0x00, 0x00, 0x01, 0x85, 0xB2}), "TEMPERATURE frame");
+static_assert(ModbusFrame<0x01, 0x03, 0x0201, 1>::value.equals({0x01, 0x03, 0x02, 0x01, 0x00, 0x01, 0xD4, 0x72}), "WATER frame");
+static_assert(ModbusFrame<0x01, 0x03, 0x0203, 1>::value.equals({0x01, 0x03, 0x02, 0x03, 0x00, 0x01, 0x75, 0xB2}), "PH frame");
+static_assert(ModbusFrame<0x01, 0x03, 0x0204, 1>::value.equals({0x01, 0x03, 0x02, 0x04, 0x00, 0x01, 0xC4, 0x73}), "NITROGEN frame");
+static_assert(ModbusFrame<0x01, 0x03, 0x0205, 1>::value.equals({0x01, 0x03, 0x02, 0x05, 0x00, 0x01, 0x95, 0xB3}), "PHOSPHORUS frame");
+static_assert(ModbusFrame<0x01, 0x03, 0x0206, 1>::value.equals({0x01, 0x03, 0x02, 0x06, 0x00, 0x01, 0x65, 0xB3}), "POTASSIUM frame");
+
+// The merged read of every soil parameter, as planned from SOIL_REGISTERS.
+static_assert(SOIL_READ_PLAN.length == 1, "Soil registers should be read in a single transaction");
+static_assert(ModbusBuildRequest(0x01,
+                                 MODBUS_READ_HOLDING_REGISTERS,
+                                 SOIL_READ_PLAN.groups[0].start,
+                                 SOIL_READ_PLAN.groups[0].count)
+                  .equals({0x01, 0x03, 0x02, 0x00, 0x00, 0x07, 0x05, 0xB0}),
+              "Soil read frame");
 
 #endif //NATURART_FIRMWARE_DATA_FRAME_H
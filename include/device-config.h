@@ -0,0 +1,449 @@
+/**
+ * @file device-config.h
+ * @brief Configuration record of the device
+ * @details This file contains the binary record holding the WiFi credentials, the sensor id,
+ * the user entry and the credentials of the types, loaded with a single read at boot. The
+ * record carries a version and a CRC. Fields are only ever appended: a record of an older
+ * version is read into the front of the struct and the new fields start empty. Devices still
+ * holding the text files of the older firmwares are migrated once, then the text files are
+ * deleted.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _DeviceConfig_h_
+#define _DeviceConfig_h_
+
+#include <config/file-system.h>
+#include <file.h>
+#include <modbus-register-map.h>
+#include <modbus-slaves.h>
+
+#include <Crc32.h>
+
+/**
+ * @brief Marks the device configuration record.
+ */
+#define DEVICE_CONFIG_MAGIC 0x4E434647
+
+/**
+ * @brief Version of the layout of the record.
+ * @details A new version appends its fields to DeviceConfig. When they need a value other than
+ * empty, LoadDeviceConfig() derives it from the older fields for a record of a lower version.
+ */
+#define DEVICE_CONFIG_VERSION 1
+
+/**
+ * @brief Largest number of type credentials of the record: one per register of each slave of
+ * the bus, and never fewer than the 16 of the first layout.
+ */
+constexpr size_t DEVICE_CONFIG_TYPES_CAPACITY = MODBUS_SLAVES_LENGTH * SOIL_REGISTERS_LENGTH > 16
+                                                    ? MODBUS_SLAVES_LENGTH * SOIL_REGISTERS_LENGTH
+                                                    : 16;
+
+static_assert(DEVICE_CONFIG_TYPES_CAPACITY <= UINT8_MAX, "The type credentials must be counted on a byte");
+
+/**
+ * @brief The credential of a type, as kept on the record
+ */
+struct DeviceTypeRecord
+{
+    // Key formatted by SensorTypeKey(), e.g. "ph" or "2:ph".
+    char key[20];
+    char id[40];
+};
+
+/**
+ * @brief The configuration of the device
+ * @details Fields are null-terminated. An empty field is not configured.
+ */
+struct DeviceConfig
+{
+    char ssid[33];
+    char wifiPassword[65];
+
+    // Id of the sensor on the broker.
+    char self[40];
+
+    char cpf[16];
+    char name[64];
+    char password[64];
+    char serialCode[40];
+
+    uint8_t typesLength;
+    DeviceTypeRecord types[DEVICE_CONFIG_TYPES_CAPACITY];
+};
+
+/**
+ * @brief The header of the record
+ */
+struct DeviceConfigHeader
+{
+    uint32_t magic;
+
+    // Version and size, in bytes, of the configuration written.
+    uint16_t version;
+    uint16_t size;
+
+    // CRC-32 of the version, the size and the configuration.
+    uint32_t crc;
+};
+
+/**
+ * @brief The record, as written on the file
+ */
+struct DeviceConfigRecord
+{
+    DeviceConfigHeader header;
+    DeviceConfig config;
+};
+
+static_assert(std::is_trivially_copyable<DeviceConfig>::value, "DeviceConfig must be trivially copyable");
+static_assert(sizeof(DeviceConfig) <= UINT16_MAX, "DeviceConfig must fit on a header");
+
+/**
+ * @brief Sets a field of the record
+ *
+ * @param field the field
+ * @param value the value, not null terminated
+ * @param length the length of the value
+ *
+ * @return bool false if the value does not fit.
+ */
+template <size_t N>
+auto SetDeviceConfigField(char (&field)[N], const char *value, size_t length) -> bool
+{
+    if (length >= N)
+    {
+        return false;
+    }
+
+    memcpy(field, value, length);
+    field[length] = '\0';
+
+    return true;
+}
+
+template <size_t N>
+auto SetDeviceConfigField(char (&field)[N], const String &value) -> bool
+{
+    return SetDeviceConfigField(field, value.c_str(), value.length());
+}
+
+/**
+ * @brief Sets a field from a line of the text files, without its "\r"
+ */
+template <size_t N>
+auto SetDeviceConfigField(char (&field)[N], const FileLine &line) -> bool
+{
+    auto length = line.length;
+
+    if (length > 0 && line.data[length - 1] == '\r')
+    {
+        length--;
+    }
+
+    return !line.partial && SetDeviceConfigField(field, line.data, length);
+}
+
+/**
+ * @brief Checksums a record, or the first `size` bytes of its configuration
+ */
+auto DeviceConfigChecksum(const DeviceConfigHeader &header, const void *config, size_t size) -> uint32_t
+{
+    auto crc = utility::crc32(&header.version, sizeof(header.version) + sizeof(header.size));
+
+    return utility::crc32(config, size, crc);
+}
+
+/**
+ * @brief Reads the text files of the older firmwares into a configuration
+ * @details Each file keeps the checks of its old reader, e.g. the session needs 2 lines.
+ *
+ * @param config receives the configuration
+ *
+ * @return bool true if any text file was found.
+ */
+auto ReadLegacyDeviceConfig(DeviceConfig &config) -> bool
+{
+    bool found = false;
+    size_t lines = 0;
+    bool valid = true;
+
+    auto read = [&](const char *path, auto callback) -> void
+    {
+        lines = 0;
+        valid = true;
+
+        if (FileExists(path))
+        {
+            found = true;
+            ReadLinesFromFile(path, '\n', [&](const FileLine &line) -> void
+                              { valid = callback(lines++, line) && valid; });
+        }
+    };
+
+    read(SESSION_FILE, [&](size_t i, const FileLine &line) -> bool
+         { return i == 0   ? SetDeviceConfigField(config.ssid, line)
+                  : i == 1 ? SetDeviceConfigField(config.wifiPassword, line)
+                           : false; });
+
+    if (!valid || lines != 2)
+    {
+        config.ssid[0] = config.wifiPassword[0] = '\0';
+    }
+
+    read(SELF_FILE, [&](size_t i, const FileLine &line) -> bool
+         { return i > 0 || SetDeviceConfigField(config.self, line); });
+
+    if (!valid)
+    {
+        config.self[0] = '\0';
+    }
+
+    read(ENTRY_FILE, [&](size_t i, const FileLine &line) -> bool
+         { return i == 0   ? SetDeviceConfigField(config.cpf, line)
+                  : i == 1 ? SetDeviceConfigField(config.name, line)
+                  : i == 2 ? SetDeviceConfigField(config.password, line)
+                  : i == 3 ? SetDeviceConfigField(config.serialCode, line)
+                           : false; });
+
+    if (!valid || lines != 4)
+    {
+        config.cpf[0] = config.name[0] = config.password[0] = config.serialCode[0] = '\0';
+    }
+
+    // a type on even lines, its id on the following odd line.
+    read(TYPING_FILE, [&](size_t i, const FileLine &line) -> bool
+         {
+             if (i / 2 >= DEVICE_CONFIG_TYPES_CAPACITY)
+             {
+                 return false;
+             }
+
+             auto &type = config.types[i / 2];
+
+             return (i & 1) ? SetDeviceConfigField(type.id, line) : SetDeviceConfigField(type.key, line); });
+
+    // an unpaired type is dropped.
+    config.typesLength = valid ? lines / 2 : 0;
+
+    return found;
+}
+
+/**
+ * @brief Save the configuration of the device
+ *
+ * @param config the configuration
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto SaveDeviceConfig(const DeviceConfig &config) -> ErrorOr<>
+{
+    LOG_DEBUG(CONFIG) << "Saving the device configuration...";
+
+    DeviceConfigHeader header = {
+        .magic = DEVICE_CONFIG_MAGIC,
+        .version = DEVICE_CONFIG_VERSION,
+        .size = sizeof(DeviceConfig),
+        .crc = 0,
+    };
+
+    header.crc = DeviceConfigChecksum(header, &config, header.size);
+
+    DeviceConfigRecord record = {header, config};
+
+    // the padding that aligns the struct is not part of the record.
+    return WriteFileAtomically(DEVICE_CONFIG_FILE, reinterpret_cast<const uint8_t *>(&record), sizeof(header) + header.size);
+}
+
+/**
+ * @brief Load the configuration of the device
+ * @details Drops a save a power loss interrupted, then migrates the text files of the older
+ * firmwares on the first boot that finds them.
+ *
+ * @param config receives the configuration, empty when there is none
+ *
+ * @return ErrorOr<> can be ok() or failure() if the record is corrupted.
+ */
+auto LoadDeviceConfig(DeviceConfig &config) -> ErrorOr<>
+{
+    config = DeviceConfig{};
+
+    RecoverAtomicWrite(DEVICE_CONFIG_FILE);
+
+    File file = LittleFS.open(DEVICE_CONFIG_FILE, "r");
+
+    if (!file)
+    {
+        if (ReadLegacyDeviceConfig(config))
+        {
+            LOG_INFO(CONFIG) << "Migrating the text files to the device configuration...";
+
+            auto result = SaveDeviceConfig(config);
+
+            if (!result.ok())
+            {
+                return result;
+            }
+
+            LittleFS.remove(SESSION_FILE);
+            LittleFS.remove(SELF_FILE);
+            LittleFS.remove(ENTRY_FILE);
+            LittleFS.remove(TYPING_FILE);
+        }
+
+        return ok();
+    }
+
+    DeviceConfigRecord record;
+
+    auto &header = record.header;
+
+    bool valid = file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+                 header.magic == DEVICE_CONFIG_MAGIC;
+
+    // a newer record keeps the fields known here at the front.
+    auto known = header.size < sizeof(DeviceConfig) ? header.size : sizeof(DeviceConfig);
+
+    valid = valid && file.read(reinterpret_cast<uint8_t *>(&record.config), known) == known;
+
+    if (valid)
+    {
+        auto crc = DeviceConfigChecksum(header, &record.config, known);
+
+        // the fields of a newer record unknown here are checksummed as they are read past.
+        uint8_t tail[64];
+        size_t remaining = header.size - known;
+
+        while (remaining > 0)
+        {
+            auto length = file.read(tail, remaining < sizeof(tail) ? remaining : sizeof(tail));
+
+            if (length == 0)
+            {
+                break;
+            }
+
+            crc = utility::crc32(tail, length, crc);
+            remaining -= length;
+        }
+
+        valid = remaining == 0 && crc == header.crc;
+    }
+
+    file.close();
+
+    if (!valid)
+    {
+        return failure({
+            .context = "LoadDeviceConfig",
+            .message = "The device configuration is corrupted",
+        });
+    }
+
+    memcpy(&config, &record.config, known);
+
+    if (config.typesLength > DEVICE_CONFIG_TYPES_CAPACITY)
+    {
+        config.typesLength = 0;
+    }
+
+    return ok();
+}
+
+/**
+ * @brief The configuration of the device, kept in RAM
+ * @details The record is read once, the getters and the emptiness checks are answered from
+ * RAM, and every change is written through to the flash.
+ *
+ * For example:
+ *   auto &config = deviceConfig.get();
+ *   deviceConfig.update([&](DeviceConfig &config) -> bool { ... });
+ */
+class DeviceConfigCache
+{
+public:
+    /**
+     * @brief Loads the record
+     * @details Must run once the file system is mounted.
+     *
+     * @return ErrorOr<> can be ok() or failure() if the record is corrupted, the cache is empty then.
+     */
+    auto load() -> ErrorOr<>
+    {
+        loaded_ = true;
+
+        return LoadDeviceConfig(config_);
+    }
+
+    // Returns the configuration, loading it on first use.
+    auto get() -> const DeviceConfig &
+    {
+        if (!loaded_)
+        {
+            load();
+        }
+
+        return config_;
+    }
+
+    /**
+     * @brief Changes the configuration and writes it through
+     *
+     * @param change called as change(DeviceConfig &), returns false to cancel the change
+     * @param context the context of the failure of a canceled change
+     *
+     * @return ErrorOr<> can be ok() or failure()
+     */
+    template <typename Change>
+    auto update(Change change, const char *context) -> ErrorOr<>
+    {
+        get();
+
+        if (!change(config_))
+        {
+            // drops what the change already touched.
+            loaded_ = false;
+
+            return failure({
+                .context = context,
+                .message = "The value does not fit on the device configuration",
+            });
+        }
+
+        auto result = SaveDeviceConfig(config_);
+
+        if (!result.ok())
+        {
+            // the RAM copy is ahead of the flash, it is read again on next use.
+            loaded_ = false;
+        }
+
+        return result;
+    }
+
+private:
+    DeviceConfig config_;
+    bool loaded_ = false;
+};
+
+/**
+ * @brief The configuration of the device.
+ */
+DeviceConfigCache deviceConfig;
+
+/**
+ * @brief Loads the configuration of the device into RAM
+ * @details Must run once the file system is mounted.
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto CacheDeviceConfig() -> ErrorOr<>
+{
+    return deviceConfig.load();
+}
+
+#endif // ! _DeviceConfig_h_
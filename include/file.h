@@ -11,11 +11,200 @@
 #ifndef _File_h_
 #define _File_h_
 
+#include <config/file-system.h>
+
 #include <UtilStringArray.h>
 #include <ErrorOr.h>
 
 #include <LittleFS.h>
 
+/**
+ * @brief Keeps the hot files open
+ * @details Opening a file walks its path and the metadata of LittleFS. Files written over
+ * and over, like the segments of the measure log, are opened once and kept open, the least
+ * recently used one being closed when the cache is full. Writes reach the flash on flush().
+ *
+ * For example:
+ *   auto &file = fileHandles.open(path, "a");
+ *   file.write(data, size);
+ *   fileHandles.flush();
+ */
+class FileHandleCache
+{
+public:
+    /**
+     * @brief Get an open handle of a file
+     *
+     * @param path The path of the file
+     * @param mode The mode of the file
+     *
+     * @return File& the handle, valid until the next open(). Check it, the file may fail to open.
+     */
+    auto open(const String &path, const char *mode) -> File &
+    {
+        size_t slot = 0;
+
+        for (size_t i = 0; i < FILE_HANDLE_CACHE_SIZE; i++)
+        {
+            auto &handle = handles_[i];
+
+            if (handle.file && handle.path == path && strcmp(handle.mode, mode) == 0)
+            {
+                handle.used = ++clock_;
+                return handle.file;
+            }
+
+            // an empty slot, or else the least recently used one.
+            if (handles_[slot].file && (!handle.file || handle.used < handles_[slot].used))
+            {
+                slot = i;
+            }
+        }
+
+        auto &handle = handles_[slot];
+
+        if (handle.file)
+        {
+            handle.file.close();
+        }
+
+        handle.file = LittleFS.open(path, mode);
+        handle.path = path;
+        strncpy(handle.mode, mode, sizeof(handle.mode) - 1);
+        handle.used = ++clock_;
+
+        return handle.file;
+    }
+
+    // Commits the writes of every open file.
+    auto flush() -> void
+    {
+        for (auto &handle : handles_)
+        {
+            if (handle.file)
+            {
+                handle.file.flush();
+            }
+        }
+    }
+
+    // Closes every handle of a file, e.g. before removing or renaming it.
+    auto close(const String &path) -> void
+    {
+        for (auto &handle : handles_)
+        {
+            if (handle.file && handle.path == path)
+            {
+                handle.file.close();
+            }
+        }
+    }
+
+    auto closeAll() -> void
+    {
+        for (auto &handle : handles_)
+        {
+            if (handle.file)
+            {
+                handle.file.close();
+            }
+        }
+    }
+
+private:
+    struct Handle
+    {
+        File file;
+        String path;
+        // A copy of the mode, the longest being "a+b".
+        char mode[4] = {};
+
+        // Value of `clock_` on last use.
+        uint32_t used = 0;
+    };
+
+    Handle handles_[FILE_HANDLE_CACHE_SIZE];
+    uint32_t clock_ = 0;
+};
+
+/**
+ * @brief The open files of the node.
+ */
+FileHandleCache fileHandles;
+
+/**
+ * @brief Replace the content of a file, all at once
+ * @details The content is written to a temporary file, which is closed and then renamed over
+ * the file. LittleFS renames atomically, so a power loss leaves either the old or the new
+ * content, never a mix. A leftover temporary file is removed by RecoverAtomicWrite().
+ *
+ * @param path The path of the file, created if it does not exist
+ * @param content The content
+ * @param size The size of the content
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto WriteFileAtomically(const String &path, const uint8_t *content, size_t size) -> ErrorOr<>
+{
+    String temp = path + FILE_TEMP_SUFFIX;
+
+    File file = LittleFS.open(temp, "w");
+
+    if (!file)
+    {
+        return failure({
+            .context = "WriteFileAtomically",
+            .message = "Failed to open the temporary file",
+        });
+    }
+
+    bool written = file.write(content, size) == size;
+
+    file.flush();
+    file.close();
+
+    if (!written)
+    {
+        LittleFS.remove(temp);
+
+        return failure({
+            .context = "WriteFileAtomically",
+            .message = "Failed to write in the temporary file",
+        });
+    }
+
+    fileHandles.close(path);
+
+    if (!LittleFS.rename(temp, path))
+    {
+        LittleFS.remove(temp);
+
+        return failure({
+            .context = "WriteFileAtomically",
+            .message = "Failed to replace the file",
+        });
+    }
+
+    return ok();
+}
+
+/**
+ * @brief Drop the temporary file of a write a power loss interrupted
+ * @details The file itself still holds its previous content. Must run before the file is read.
+ *
+ * @param path The path of the file
+ */
+auto RecoverAtomicWrite(const String &path) -> void
+{
+    String temp = path + FILE_TEMP_SUFFIX;
+
+    if (LittleFS.exists(temp))
+    {
+        LOG_WARN(STORAGE) << "Dropping the interrupted write of '" << path << "'";
+        LittleFS.remove(temp);
+    }
+}
+
 /**
  * @brief Write in a file
  *
@@ -32,42 +221,117 @@ auto WriteInFile(String path, String content, bool endline) -> ErrorOr<>
             .message = "File does not exist",
         });
 
-    File file = LittleFS.open(path, "w");
-
-    if (!file)
+    if (endline)
     {
-        return failure({
-            .context = "WriteInFile",
-            .message = "Failed to open the file",
-        });
+        content += "\r\n";
     }
 
-    if (endline ? file.println(content) : file.print(content))
+    return WriteFileAtomically(path, reinterpret_cast<const uint8_t *>(content.c_str()), content.length());
+}
+
+/**
+ * @brief A line of a file, pointing into the buffer of its reader
+ * @details Valid until the next line is read. Not null terminated.
+ */
+struct FileLine
+{
+    const char *data;
+    size_t length;
+
+    // The line is longer than FILE_READ_BUFFER_SIZE, the next view continues it.
+    bool partial;
+};
+
+/**
+ * @brief Reads the lines of a file in blocks of FILE_READ_BUFFER_SIZE bytes
+ * @details Lines are handed out as views into the buffer of the reader, without touching the
+ * heap. A last line without the end character is not a line, as it was never fully written.
+ *
+ * For example:
+ *   FileLineReader reader(file, '\n');
+ *   FileLine line;
+ *   while (reader.next(line)) { ... }
+ */
+class FileLineReader
+{
+public:
+    FileLineReader(File &file, char end) : file_(file), end_(end) {}
+
+    /**
+     * @brief Reads the next line
+     *
+     * @param line receives the line, without the end character
+     *
+     * @return bool false at the end of the file.
+     */
+    auto next(FileLine &line) -> bool
     {
-        return ok();
+        while (true)
+        {
+            for (; scan_ < length_; scan_++)
+            {
+                if (buffer_[scan_] == end_)
+                {
+                    line = {.data = buffer_ + start_, .length = scan_ - start_, .partial = false};
+                    start_ = ++scan_;
+                    return true;
+                }
+            }
+
+            // moves the unfinished line to the front of the buffer.
+            if (start_ > 0)
+            {
+                memmove(buffer_, buffer_ + start_, length_ - start_);
+                length_ -= start_;
+                scan_ = length_;
+                start_ = 0;
+            }
+
+            if (length_ == sizeof(buffer_))
+            {
+                line = {.data = buffer_, .length = length_, .partial = true};
+                start_ = scan_ = length_;
+                return true;
+            }
+
+            auto read = file_.read(reinterpret_cast<uint8_t *>(buffer_ + length_), sizeof(buffer_) - length_);
+
+            if (read == 0)
+            {
+                return false;
+            }
+
+            length_ += read;
+        }
     }
 
-    return failure({
-        .context = "WriteInFile",
-        .message = "Failed to write in the file",
-    });
-}
+private:
+    File &file_;
+    char end_;
+
+    char buffer_[FILE_READ_BUFFER_SIZE];
+
+    // Bytes on the buffer, start of the current line, and first byte not searched yet.
+    size_t length_ = 0;
+    size_t start_ = 0;
+    size_t scan_ = 0;
+};
 
 /**
- * @brief Read a file
+ * @brief Read the lines of a file, one view at a time
  *
  * @param path The path of the file
  * @param end The end of the line
+ * @param callback Called as callback(const FileLine &) for each line
  *
- * @return ErrorOr<utility::StringArray> can be the lines of the file or failure().
+ * @return ErrorOr<> can be ok() or failure()
  */
-auto ReadFromFile(String path, char end) -> ErrorOr<utility::StringArray>
+template <typename Callback>
+auto ReadLinesFromFile(const String &path, char end, Callback callback) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "ReadFromFile: " << path;
-
     if (!LittleFS.exists(path))
         return failure({
-            .context = "ReadFromFile",
+            .context = "ReadLinesFromFile",
             .message = "File does not exist",
         });
 
@@ -76,28 +340,56 @@ auto ReadFromFile(String path, char end) -> ErrorOr<utility::StringArray>
     if (!file)
     {
         return failure({
-            .context = "ReadFromFile",
+            .context = "ReadLinesFromFile",
             .message = "Failed to open the file",
         });
     }
 
+    FileLineReader reader(file, end);
+    FileLine line;
+
+    while (reader.next(line))
+    {
+        callback(line);
+    }
+
+    file.close();
+
+    return ok();
+}
+
+/**
+ * @brief Read a file
+ *
+ * @param path The path of the file
+ * @param end The end of the line
+ *
+ * @return ErrorOr<utility::StringArray> can be the lines of the file or failure().
+ */
+auto ReadFromFile(String path, char end) -> ErrorOr<utility::StringArray>
+{
+    LOG_TRACE(STORAGE) << "ReadFromFile: " << path;
+
     utility::StringArray lines;
     String buff = "";
 
-    while (file.available() > 0)
-    {
-        char c = (char)file.read();
+    auto result = ReadLinesFromFile(path, end, [&](const FileLine &line) -> void
+                                    {
+                                        buff.concat(line.data, line.length);
 
-        if (c == end)
-        {
-            lines.add(buff);
-            buff = "";
-            continue;
-        }
-        buff += c;
+                                        if (!line.partial)
+                                        {
+                                            lines.add(buff);
+                                            buff = "";
+                                        }
+                                    });
+
+    if (!result.ok())
+    {
+        return failure(result.error());
     }
 
-    INTERNAL_DEBUG() << "ReadFromFile: " << lines.length() << " lines";
+    LOG_TRACE(STORAGE) << "ReadFromFile: " << lines.length() << " lines";
 
     return ok(lines);
 }
@@ -117,6 +409,8 @@ auto DeleteFile(String path) -> ErrorOr<>
             .message = "File does not exist",
         });
 
+    fileHandles.close(path);
+
     if (LittleFS.remove(path))
         return ok();
 
@@ -141,9 +435,11 @@ auto CleanFile(String path) -> ErrorOr<>
             .message = "File does not exist",
         });
 
+    fileHandles.close(path);
+
     File file = LittleFS.open(path, "w");
 
-    INTERNAL_DEBUG() << "Cleaning file '" << path << "'...";
+    LOG_TRACE(STORAGE) << "Cleaning file '" << path << "'...";
 
     if (!file)
     {
@@ -246,7 +542,7 @@ auto CloseFile(File &file) -> ErrorOr<>
         });
     }
 
-    INTERNAL_DEBUG() << "Closing file...";
+    LOG_TRACE(STORAGE) << "Closing file...";
 
     file.close();
 
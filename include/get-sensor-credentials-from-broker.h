@@ -14,8 +14,10 @@
 #include <PubSubClient.h>
 
 #include <sensor-typing.h>
+#include <message-arena.h>
 #include <user-entry.h>
 #include <wifi-connection.h>
+#include <wifi-credentials.h>
 #include <uuid-factory.h>
 
 /**
@@ -25,13 +27,13 @@
  */
 auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing sensor credentials by naturart broker...";
+    LOG_INFO(BROKER) << "Syncing sensor credentials by naturart broker...";
 
     if (WiFi.status() != WL_CONNECTED)
     {
-        INTERNAL_DEBUG() << "WiFi is not connected";
+        LOG_WARN(BROKER) << "WiFi is not connected";
 
-        CleanFile(SESSION_FILE);
+        ClearWiFiCredentials();
         ESP.restart();
     }
 
@@ -46,7 +48,7 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
 
     client.setServer(host, 1883);
 
-    INTERNAL_DEBUG() << "Connecting to MQTT broker...";
+    LOG_DEBUG(BROKER) << "Connecting to MQTT broker...";
 
     auto reconnect = [&client]() -> void
     {
@@ -60,7 +62,7 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
             // Attempt to connect
             if (client.connect(clientId.c_str()))
             {
-                INTERNAL_DEBUG() << "Connected to MQTT broker";
+                LOG_INFO(BROKER) << "Connected to MQTT broker";
             }
         }
     };
@@ -70,29 +72,24 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
     client.setCallback([&](char *topic, byte *payload, unsigned int length) -> void
                        {
                         if(uuid != topic) {
-                            INTERNAL_DEBUG() << "Invalid topic. Ignoring...";
+                            LOG_WARN(BROKER) << "Invalid topic. Ignoring...";
                             return; 
                         }
 
-                        String spayload = "";
-                        spayload.reserve(length);
+                        LOG_DEBUG(BROKER) << "Message arrived [" << topic << "]: " << length << " bytes";
 
-                        for (unsigned int i = 0; i < length; i++)
-                        {
-                            spayload += (char)payload[i];
-                        }
-
-                        INTERNAL_DEBUG() << "Message arrived [" << topic << "]: " << spayload;
+                        utility::ArenaScope scope(messageArena);
 
+                        auto parseResult = CredentialsFromBrokerPayload(reinterpret_cast<const char *>(payload), length, messageArena);
 
-                        auto parseResult = CredentialsFromBrokerPayload(spayload);
+                        LOG_DEBUG(BROKER) << "Message arena high water: " << messageArena.highWater() << " of " << messageArena.capacity() << " bytes";
 
                         if (!parseResult.ok())
                         {
-                            INTERNAL_DEBUG() << "Could not extract credentials from json";
-                            INTERNAL_DEBUG() << parseResult.error();
+                            LOG_ERROR(BROKER) << "Could not extract credentials from json";
+                            LOG_ERROR(BROKER) << parseResult.error();
                             // forces esp to collect the data again from the user
-                            CleanFile(ENTRY_FILE);
+                            ClearUserEntry();
                         }
                         else
                         {
@@ -100,10 +97,10 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
 
                             if (credentials.length() == 0)
                             {
-                                INTERNAL_DEBUG() << "Invalid credentials number";
+                                LOG_ERROR(BROKER) << "Invalid credentials number";
 
                                 // forces esp to collect the data again from the user
-                                CleanFile(ENTRY_FILE);
+                                ClearUserEntry();
                             }
                             else
                             {
@@ -111,11 +108,11 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
 
                                 if (!saveResult.ok())
                                 {
-                                    INTERNAL_DEBUG() << saveResult.error();
+                                    LOG_ERROR(BROKER) << saveResult.error();
                                 }
                                 else
                                 {
-                                    INTERNAL_DEBUG() << "Saved sensor credentials";
+                                    LOG_INFO(BROKER) << "Saved sensor credentials";
                                 }
                             }
                         }
@@ -124,11 +121,22 @@ auto GetSensorCredentialsFromBroker(String &id) -> ErrorOr<>
 
     client.subscribe(uuid.c_str());
 
-    INTERNAL_DEBUG() << "Subcribed on topic '" << uuid.c_str() << "'";
+    LOG_INFO(BROKER) << "Subcribed on topic '" << uuid.c_str() << "'";
+
+    {
+        utility::ArenaScope scope(messageArena);
 
-    String json = "{\"uuid\": \"" + uuid + "\", \"id\": \"" + id + "\"}";
+        auto json = messageArena.format("{\"uuid\": \"%s\", \"id\": \"%s\"}", uuid.c_str(), id.c_str());
 
-    client.publish("credentials", json.c_str());
+        if (json == nullptr)
+        {
+            LOG_ERROR(BROKER) << "The request does not fit on the message arena";
+        }
+        else
+        {
+            client.publish("credentials", json);
+        }
+    }
 
     // Await the payload of broker to restart.
     while (true)
@@ -12,8 +12,10 @@
 
 #include <user-entry.h>
 #include <wifi-connection.h>
+#include <wifi-credentials.h>
 #include <uuid-factory.h>
 #include <sensor-self.h>
+#include <message-arena.h>
 
 #include <PubSubClient.h>
 
@@ -24,13 +26,13 @@
  */
 [[noreturn]] auto GetSensorIdFromBroker(UserEntry &entry) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing sensor id by naturart broker...";
+    LOG_INFO(BROKER) << "Syncing sensor id by naturart broker...";
 
     if (WiFi.status() != WL_CONNECTED)
     {
-        INTERNAL_DEBUG() << "WiFi is not connected";
+        LOG_WARN(BROKER) << "WiFi is not connected";
 
-        CleanFile(SESSION_FILE);
+        ClearWiFiCredentials();
         ESP.restart();
     }
 
@@ -45,7 +47,7 @@
 
     client.setServer(host, 1883);
 
-    INTERNAL_DEBUG() << "Connecting to MQTT broker...";
+    LOG_DEBUG(BROKER) << "Connecting to MQTT broker...";
 
     auto reconnect = [&client]() -> void
     {
@@ -59,7 +61,7 @@
             // Attempt to connect
             if (client.connect(clientId.c_str()))
             {
-                INTERNAL_DEBUG() << "Connected to MQTT broker";
+                LOG_INFO(BROKER) << "Connected to MQTT broker";
             }
         }
     };
@@ -69,40 +71,35 @@
     client.setCallback([&](char *topic, byte *payload, unsigned int length) -> void
                        {   
                         if(entry.id != topic) {
-                            INTERNAL_DEBUG() << "Invalid topic. Ignoring...";
+                            LOG_WARN(BROKER) << "Invalid topic. Ignoring...";
                             return; 
                         }
 
-                        String spayload = "";
-                        spayload.reserve(length);
+                        LOG_DEBUG(BROKER) << "Message arrived [" << topic << "]: " << length << " bytes";
 
-                        for (unsigned int i = 0; i < length; i++)
-                        {
-                            spayload += (char)payload[i];
-                        }
-
-                        INTERNAL_DEBUG() << "Message arrived [" << topic << "]: " << spayload;
+                        utility::ArenaScope scope(messageArena);
 
+                        auto parseResult = SelfFromBrokerPayload(reinterpret_cast<const char *>(payload), length, messageArena);
 
-                        auto parseResult = SelfFromBrokerPayload(spayload);
+                        LOG_DEBUG(BROKER) << "Message arena high water: " << messageArena.highWater() << " of " << messageArena.capacity() << " bytes";
 
                         if (!parseResult.ok())
                         {
-                            INTERNAL_DEBUG() << "Could not extract credentials from json";
-                            INTERNAL_DEBUG() << parseResult.error();
+                            LOG_ERROR(BROKER) << "Could not extract credentials from json";
+                            LOG_ERROR(BROKER) << parseResult.error();
                             // forces esp to collect the data again from the user
-                            CleanFile(ENTRY_FILE);
+                            ClearUserEntry();
                         }
                         else
                         {
                             auto id = parseResult.unwrap();
 
-                            if (id.length() == 0)
+                            if (id[0] == '\0')
                             {
-                                INTERNAL_DEBUG() << "Invalid credentials number";
+                                LOG_ERROR(BROKER) << "Invalid credentials number";
 
                                 // forces esp to collect the data again from the user
-                                CleanFile(ENTRY_FILE);
+                                ClearUserEntry();
                             }
                             else
                             {
@@ -110,11 +107,11 @@
 
                                 if (!saveResult.ok())
                                 {
-                                    INTERNAL_DEBUG() << saveResult.error();
+                                    LOG_ERROR(BROKER) << saveResult.error();
                                 }
                                 else
                                 {
-                                    INTERNAL_DEBUG() << "Saved sensor credentials";
+                                    LOG_INFO(BROKER) << "Saved sensor credentials";
                                 }
                             }
                         }
@@ -123,9 +120,22 @@
 
     client.subscribe(entry.id.c_str());
 
-    INTERNAL_DEBUG() << "Subcribed on topic '" << entry.id.c_str() << "'";
+    LOG_INFO(BROKER) << "Subcribed on topic '" << entry.id.c_str() << "'";
+
+    {
+        utility::ArenaScope scope(messageArena);
+
+        auto json = entry.ToJson(messageArena);
 
-    client.publish("sync", entry.ToJson().c_str());
+        if (json == nullptr)
+        {
+            LOG_ERROR(BROKER) << "The user entry does not fit on the message arena";
+        }
+        else
+        {
+            client.publish("sync", json);
+        }
+    }
 
     // Await the payload of broker to restart.
     while (true)
@@ -23,7 +23,7 @@
  */
 [[noreturn]] auto GetUserEntryFromWebServer() -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing sensor credentials from Naturart server...";
+    LOG_INFO(PORTAL) << "Syncing sensor credentials from Naturart server...";
 
     // Requires WiFi to be disconnected to avoid conflicts with the web server.
     if (WiFi.isConnected())
@@ -48,7 +48,7 @@
     server.begin();
     TurnOnBuiltInLed();
 
-    INTERNAL_DEBUG() << "Server started. Waiting for user entry...";
+    LOG_INFO(PORTAL) << "Server started. Waiting for user entry...";
 
     while (true)
     {
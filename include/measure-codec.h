@@ -0,0 +1,300 @@
+/**
+ * @file measure-codec.h
+ * @brief Compressed encoding of measures
+ * @details This file contains the encoding shared by the measure log and the payload sent to
+ * the broker. Measures are grouped in series of the same slave and type, and each series is
+ * stored column by column: timestamps as deltas of deltas, values as deltas, and flags as
+ * runs, all as zig-zag varints. A periodic series of slowly moving values costs about two
+ * bytes per measure instead of twelve.
+ *
+ * Block layout:
+ *   byte    MEASURE_CODEC_VERSION
+ *   varint  number of series
+ *   for each series:
+ *     byte    slave
+ *     byte    type, index on SOIL_REGISTERS
+ *     varint  number of measures
+ *     varint  timestamp of the first measure
+ *     zigzag  value of the first measure
+ *     zigzag  delta of delta of each following timestamp
+ *     zigzag  delta of each following value
+ *     runs of (varint length, byte flags) covering every measure
+ *
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MeasureCodec_h_
+#define _MeasureCodec_h_
+
+#include <measure.h>
+
+#include <ErrorOr.h>
+#include <Varint.h>
+
+/**
+ * @brief Version of the block layout.
+ */
+#define MEASURE_CODEC_VERSION 1
+
+/**
+ * @brief Largest number of measures of a block.
+ */
+#ifndef MEASURE_BLOCK_CAPACITY
+#define MEASURE_BLOCK_CAPACITY 48
+#endif // ! MEASURE_BLOCK_CAPACITY
+
+/**
+ * @brief Largest size, in bytes, of an encoded block: every measure on its own series.
+ */
+#define MEASURE_BLOCK_MAX_SIZE (1 + VARINT_MAX_SIZE + MEASURE_BLOCK_CAPACITY * (2 + 3 * VARINT_MAX_SIZE + VARINT_MAX_SIZE + 1))
+
+static_assert(MEASURE_BLOCK_CAPACITY > 0 && MEASURE_BLOCK_CAPACITY <= UINT8_MAX, "MEASURE_BLOCK_CAPACITY must be in 1..255");
+
+/**
+ * @brief Encodes measures into a block
+ *
+ * @param measures the measures, at most MEASURE_BLOCK_CAPACITY
+ * @param length the number of measures
+ * @param out receives the block
+ * @param capacity the size of `out`, MEASURE_BLOCK_MAX_SIZE always fits
+ *
+ * @return size_t the size of the block, or 0 if it does not fit on `out`.
+ */
+auto EncodeMeasureBlock(const Measure *measures, size_t length, uint8_t *out, size_t capacity) -> size_t
+{
+    if (length > MEASURE_BLOCK_CAPACITY)
+    {
+        return 0;
+    }
+
+    utility::VarintWriter writer(out, capacity);
+
+    // index of the series of each measure, in order of first appearance.
+    uint8_t series[MEASURE_BLOCK_CAPACITY];
+    uint8_t firsts[MEASURE_BLOCK_CAPACITY];
+    size_t count = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        size_t s = 0;
+
+        for (; s < count; s++)
+        {
+            auto &first = measures[firsts[s]];
+
+            if (first.slave == measures[i].slave && first.type == measures[i].type)
+            {
+                break;
+            }
+        }
+
+        if (s == count)
+        {
+            firsts[count++] = i;
+        }
+
+        series[i] = s;
+    }
+
+    writer.writeByte(MEASURE_CODEC_VERSION);
+    writer.write(count);
+
+    for (size_t s = 0; s < count; s++)
+    {
+        auto &first = measures[firsts[s]];
+        size_t measuresOfSeries = 0;
+
+        for (size_t i = firsts[s]; i < length; i++)
+        {
+            measuresOfSeries += series[i] == s;
+        }
+
+        writer.writeByte(first.slave);
+        writer.writeByte(first.type);
+        writer.write(measuresOfSeries);
+        writer.write(first.timestamp);
+        writer.writeSigned(first.value);
+
+        // deltas wrap around, the decoder wraps back the same way.
+        uint32_t timestamp = first.timestamp;
+        uint32_t delta = 0;
+
+        for (size_t i = firsts[s] + 1; i < length; i++)
+        {
+            if (series[i] != s)
+            {
+                continue;
+            }
+
+            uint32_t next = measures[i].timestamp - timestamp;
+
+            writer.writeSigned(static_cast<int32_t>(next - delta));
+
+            delta = next;
+            timestamp = measures[i].timestamp;
+        }
+
+        int32_t value = first.value;
+
+        for (size_t i = firsts[s] + 1; i < length; i++)
+        {
+            if (series[i] != s)
+            {
+                continue;
+            }
+
+            writer.writeSigned(static_cast<int32_t>(static_cast<uint32_t>(measures[i].value) - static_cast<uint32_t>(value)));
+
+            value = measures[i].value;
+        }
+
+        uint32_t run = 0;
+        uint8_t flags = first.flags;
+
+        for (size_t i = firsts[s]; i < length; i++)
+        {
+            if (series[i] != s)
+            {
+                continue;
+            }
+
+            if (measures[i].flags != flags)
+            {
+                writer.write(run);
+                writer.writeByte(flags);
+
+                run = 0;
+                flags = measures[i].flags;
+            }
+
+            run++;
+        }
+
+        writer.write(run);
+        writer.writeByte(flags);
+    }
+
+    return writer.overflow() ? 0 : writer.length();
+}
+
+/**
+ * @brief Decodes a block encoded by EncodeMeasureBlock()
+ * @details Measures come out grouped by series. The block is read once, front to back, so
+ * it can be streamed from a file instead of being loaded first.
+ *
+ * @param reader the reader of the block, e.g. a utility::VarintReader
+ * @param out receives the measures
+ * @param capacity the number of measures that fit on `out`
+ *
+ * @return ErrorOr<size_t> the number of measures decoded.
+ */
+template <typename Reader>
+auto DecodeMeasureBlock(Reader &reader, Measure *out, size_t capacity) -> ErrorOr<size_t>
+{
+    if (reader.readByte() != MEASURE_CODEC_VERSION)
+    {
+        return failure({
+            .context = "DecodeMeasureBlock",
+            .message = "Unknown block version",
+        });
+    }
+
+    auto count = reader.read();
+    size_t length = 0;
+
+    for (uint32_t s = 0; s < count && !reader.malformed(); s++)
+    {
+        auto slave = reader.readByte();
+        auto type = reader.readByte();
+        auto measuresOfSeries = reader.read();
+
+        if (type >= SOIL_REGISTERS_LENGTH || measuresOfSeries == 0 || measuresOfSeries > capacity - length)
+        {
+            return failure({
+                .context = "DecodeMeasureBlock",
+                .message = "Invalid series",
+            });
+        }
+
+        auto series = out + length;
+
+        uint32_t timestamp = reader.read();
+        uint32_t delta = 0;
+
+        series[0] = {
+            .timestamp = timestamp,
+            .value = reader.readSigned(),
+            .parameter = SOIL_REGISTERS[type].parameter,
+            .flags = MEASURE_FLAG_NONE,
+            .type = type,
+            .slave = slave,
+        };
+
+        for (uint32_t i = 1; i < measuresOfSeries; i++)
+        {
+            delta += static_cast<uint32_t>(reader.readSigned());
+            timestamp += delta;
+
+            series[i] = series[0];
+            series[i].timestamp = timestamp;
+        }
+
+        for (uint32_t i = 1; i < measuresOfSeries; i++)
+        {
+            series[i].value = static_cast<int32_t>(static_cast<uint32_t>(series[i - 1].value) + static_cast<uint32_t>(reader.readSigned()));
+        }
+
+        for (uint32_t i = 0; i < measuresOfSeries && !reader.malformed();)
+        {
+            auto run = reader.read();
+            auto flags = reader.readByte();
+
+            if (run == 0 || run > measuresOfSeries - i)
+            {
+                return failure({
+                    .context = "DecodeMeasureBlock",
+                    .message = "Invalid flags",
+                });
+            }
+
+            for (; run > 0; run--)
+            {
+                series[i++].flags = flags;
+            }
+        }
+
+        length += measuresOfSeries;
+    }
+
+    if (reader.malformed() || !reader.atEnd())
+    {
+        return failure({
+            .context = "DecodeMeasureBlock",
+            .message = "Truncated block",
+        });
+    }
+
+    return ok(length);
+}
+
+/**
+ * @brief Decodes a block encoded by EncodeMeasureBlock()
+ *
+ * @param block the block
+ * @param size the size of the block
+ * @param out receives the measures
+ * @param capacity the number of measures that fit on `out`
+ *
+ * @return ErrorOr<size_t> the number of measures decoded.
+ */
+auto DecodeMeasureBlock(const uint8_t *block, size_t size, Measure *out, size_t capacity) -> ErrorOr<size_t>
+{
+    utility::VarintReader reader(block, size);
+
+    return DecodeMeasureBlock(reader, out, capacity);
+}
+
+#endif // ! _MeasureCodec_h_
@@ -0,0 +1,155 @@
+/**
+ * @file measure-filter.h
+ * @brief Filter of the sensor readings.
+ * @details This file contains the filter applied between the raw readings of the sensor and
+ * the creation of a measure: a median window rejects spikes, MEASURE_OVERSAMPLING readings are
+ * averaged into one measure and an exponential moving average smooths consecutive measures.
+ * Integer arithmetic only, the ESP8266 has no FPU.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MeasureFilter_h_
+#define _MeasureFilter_h_
+
+#include <config/measure.h>
+
+#include <RingBuffer.h>
+
+#include <c_types.h>
+
+static_assert(MEASURE_OVERSAMPLING > 0, "MEASURE_OVERSAMPLING must be positive");
+static_assert(MEASURE_MEDIAN_WINDOW > 0, "MEASURE_MEDIAN_WINDOW must be positive");
+static_assert(MEASURE_OVERSAMPLING >= MEASURE_MEDIAN_WINDOW, "MEASURE_OVERSAMPLING must fill the median window");
+static_assert(MEASURE_EMA_ALPHA > 0 && MEASURE_EMA_ALPHA <= 256, "MEASURE_EMA_ALPHA must be in 1..256");
+
+/**
+ * @brief Fractional bits of the moving average.
+ */
+#define MEASURE_EMA_SHIFT 8
+
+/**
+ * @brief The filter of a single parameter
+ *
+ * For example:
+ *   filter.add(raw); // MEASURE_OVERSAMPLING times
+ *   auto value = filter.take();
+ */
+class MeasureFilter
+{
+public:
+    /**
+     * @brief Adds a raw reading
+     * @details Only the medians of full windows are averaged, so a spike is always outvoted
+     * by its neighbours, even on the first readings of a measure.
+     *
+     * @param raw the raw value of the register
+     */
+    auto add(int32_t raw) -> void
+    {
+        window_.push(raw);
+
+        if (!window_.isFull())
+        {
+            return;
+        }
+
+        sum_ += median();
+        samples_++;
+    }
+
+    /**
+     * @brief Closes the readings added since the last call into a measure
+     * @details The median window starts empty again, so the next measure only sees its own
+     * readings.
+     *
+     * @return int32_t the filtered value, in the unit of the raw readings.
+     */
+    auto take() -> int32_t
+    {
+        if (samples_ == 0)
+        {
+            return value();
+        }
+
+        // rounds half away from zero.
+        int32_t half = sum_ < 0 ? -(samples_ / 2) : samples_ / 2;
+        int32_t mean = (sum_ + half) / samples_;
+        int32_t scaled = mean * (1 << MEASURE_EMA_SHIFT);
+
+        if (!primed_)
+        {
+            average_ = scaled;
+            primed_ = true;
+        }
+        else
+        {
+            average_ += static_cast<int32_t>(static_cast<int64_t>(scaled - average_) * MEASURE_EMA_ALPHA / 256);
+        }
+
+        sum_ = 0;
+        samples_ = 0;
+        window_.clear();
+
+        return value();
+    }
+
+    /**
+     * @brief Drops the readings added since the last take()
+     */
+    auto discard() -> void
+    {
+        sum_ = 0;
+        samples_ = 0;
+        window_.clear();
+    }
+
+    auto reset() -> void { *this = MeasureFilter(); }
+
+    // Checks whether a measure was already taken, i.e. the moving average has a history.
+    auto primed() const -> bool { return primed_; }
+
+private:
+    // The rounded moving average.
+    auto value() const -> int32_t
+    {
+        return (average_ + (1 << (MEASURE_EMA_SHIFT - 1))) >> MEASURE_EMA_SHIFT;
+    }
+
+    // The median of the window, the lower one on an even count.
+    // REQUIRES: the window is not empty.
+    auto median() const -> int32_t
+    {
+        int32_t sorted[MEASURE_MEDIAN_WINDOW];
+        size_t length = window_.length();
+
+        // insertion sort, the window holds a handful of items.
+        for (size_t i = 0; i < length; i++)
+        {
+            auto item = window_[i];
+            size_t j = i;
+
+            for (; j > 0 && sorted[j - 1] > item; j--)
+            {
+                sorted[j] = sorted[j - 1];
+            }
+
+            sorted[j] = item;
+        }
+
+        return sorted[(length - 1) / 2];
+    }
+
+    utility::RingBuffer<int32_t, MEASURE_MEDIAN_WINDOW> window_;
+
+    int32_t sum_ = 0;
+    int32_t samples_ = 0;
+
+    // Moving average with MEASURE_EMA_SHIFT fractional bits.
+    int32_t average_ = 0;
+    bool primed_ = false;
+};
+
+#endif // ! _MeasureFilter_h_
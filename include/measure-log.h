@@ -0,0 +1,730 @@
+/**
+ * @file measure-log.h
+ * @brief Append-only log of measures
+ * @details This file contains the log the measures are kept in until they are delivered.
+ * Each save appends a block of measures, encoded by measure-codec.h and prefixed by its size
+ * and CRC, to numbered segments kept by the store of measure-store.h. A save only
+ * writes the new block, a power loss can only tear the last block, and delivered segments
+ * are reclaimed as a whole.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MeasureLog_h_
+#define _MeasureLog_h_
+
+#include <config/file-system.h>
+#include <config/measure.h>
+#include <measure.h>
+#include <measure-codec.h>
+#include <measure-store.h>
+#include <file.h>
+
+#include <Crc32.h>
+#include <StringView.h>
+
+/**
+ * @brief First byte of every block of the log.
+ */
+#define MEASURE_LOG_BLOCK_MAGIC 0xB7
+
+/**
+ * @brief The header of a block of the log
+ */
+struct MeasureLogBlockHeader
+{
+    uint8_t magic;
+
+    // Number of measures of the block.
+    uint8_t count;
+
+    // Size, in bytes, of the encoded block following the header.
+    uint16_t size;
+
+    // CRC-32 of the encoded block.
+    uint32_t crc;
+};
+
+/**
+ * @brief Size, in bytes, a block takes on a segment of a store, header and alignment included
+ */
+template <typename Store>
+constexpr auto MeasureLogBlockSpan(size_t size) -> uint32_t
+{
+    return (sizeof(MeasureLogBlockHeader) + size + Store::ALIGNMENT - 1) / Store::ALIGNMENT * Store::ALIGNMENT;
+}
+
+static_assert(MEASURE_BLOCK_MAX_SIZE <= UINT16_MAX, "MEASURE_BLOCK_MAX_SIZE must fit on a block header");
+static_assert(MEASURE_LOG_MAX_SEGMENTS > 1, "MEASURE_LOG_MAX_SEGMENTS must keep a closed segment");
+
+/**
+ * @brief A position on the log
+ */
+struct MeasureLogPosition
+{
+    uint32_t segment = 0;
+
+    // Offset, in bytes, of the block on the segment.
+    uint32_t offset = 0;
+
+    // Index of the measure on the block.
+    uint32_t record = 0;
+};
+
+/**
+ * @brief Size, in bytes, of the buffer blocks are streamed from the flash through.
+ */
+#ifndef MEASURE_LOG_READ_BUFFER_SIZE
+#define MEASURE_LOG_READ_BUFFER_SIZE 64
+#endif // ! MEASURE_LOG_READ_BUFFER_SIZE
+
+/**
+ * @brief Streams the encoded bytes of a block from a segment, checksumming them on the way
+ */
+template <typename Store>
+class MeasureBlockSource
+{
+public:
+    /**
+     * @param store the store of the segment
+     * @param segment the segment
+     * @param offset the offset of the encoded block on the segment
+     * @param size the size of the encoded block
+     */
+    MeasureBlockSource(Store &store, uint32_t segment, uint32_t offset, size_t size)
+        : store_(store), segment_(segment), offset_(offset), remaining_(size) {}
+
+    auto next(uint8_t &byte) -> bool
+    {
+        if (position_ == length_)
+        {
+            size_t length = remaining_ < sizeof(buffer_) ? remaining_ : sizeof(buffer_);
+
+            length_ = length == 0 ? 0 : store_.read(segment_, offset_, buffer_, length);
+            position_ = 0;
+            offset_ += length_;
+            remaining_ -= length_;
+            crc_ = utility::crc32(buffer_, length_, crc_);
+
+            if (length_ == 0)
+            {
+                return false;
+            }
+        }
+
+        byte = buffer_[position_++];
+        return true;
+    }
+
+    auto atEnd() const -> bool { return position_ == length_ && remaining_ == 0; }
+
+    // Reads the rest of the block, then returns the CRC-32 of all of it.
+    auto crc() -> uint32_t
+    {
+        uint8_t byte;
+
+        while (next(byte))
+        {
+        }
+
+        return crc_;
+    }
+
+private:
+    Store &store_;
+    uint32_t segment_;
+    uint32_t offset_;
+    size_t remaining_;
+
+    uint8_t buffer_[MEASURE_LOG_READ_BUFFER_SIZE];
+    size_t length_ = 0;
+    size_t position_ = 0;
+
+    uint32_t crc_ = 0;
+};
+
+/**
+ * @brief Reads the header of the block at an offset of a segment
+ *
+ * @return bool false past the end of the segment, or if the header is not valid.
+ */
+template <typename Store>
+auto ReadMeasureLogBlockHeader(Store &store, uint32_t segment, uint32_t offset, MeasureLogBlockHeader &header) -> bool
+{
+    return store.read(segment, offset, reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+           header.magic == MEASURE_LOG_BLOCK_MAGIC &&
+           header.size <= MEASURE_BLOCK_MAX_SIZE;
+}
+
+/**
+ * @brief The log of measures, on the segments of a store of measure-store.h
+ *
+ * For example:
+ *   log.open();
+ *   log.append(measures, length);
+ *   log.sync();
+ *   // once delivered
+ *   log.acknowledge(position);
+ */
+template <typename Store>
+class BasicMeasureLog
+{
+    static_assert(MeasureLogBlockSpan<Store>(MEASURE_BLOCK_MAX_SIZE) <= Store::SEGMENT_SIZE, "A segment must hold the largest block");
+
+public:
+    /**
+     * @param args the arguments of the constructor of the store
+     */
+    template <typename... Args>
+    explicit BasicMeasureLog(Args &&...args) : store_(args...) {}
+
+    /**
+     * @brief Opens the log, dropping the torn block a power loss may have left
+     *
+     * @return ErrorOr<> can be ok() or failure()
+     */
+    auto open() -> ErrorOr<>
+    {
+        if (!store_.begin())
+        {
+            return failure({
+                .context = "MeasureLog",
+                .message = "Failed to prepare the store",
+            });
+        }
+
+        if (!store_.segments(first_, last_))
+        {
+            first_ = last_ = 1;
+        }
+
+        size_ = recover(last_);
+
+        loadAcknowledgement();
+
+        open_ = true;
+
+        return ok();
+    }
+
+    auto isOpen() const -> bool { return open_; }
+
+    /**
+     * @brief Appends measures as a single block
+     * @details The block reaches the flash on the next sync().
+     *
+     * @param measures the measures, at most MEASURE_BLOCK_CAPACITY
+     * @param length the number of measures
+     *
+     * @return ErrorOr<> can be ok() or failure()
+     */
+    auto append(const Measure *measures, size_t length) -> ErrorOr<>
+    {
+        MeasureLogBlockHeader header;
+
+        auto encoded = block_ + sizeof(header);
+        auto size = EncodeMeasureBlock(measures, length, encoded, MEASURE_BLOCK_MAX_SIZE);
+
+        if (size == 0)
+        {
+            return failure({
+                .context = "MeasureLog",
+                .message = "Failed to encode the block",
+            });
+        }
+
+        header = {
+            .magic = MEASURE_LOG_BLOCK_MAGIC,
+            .count = static_cast<uint8_t>(length),
+            .size = static_cast<uint16_t>(size),
+            .crc = utility::crc32(encoded, size),
+        };
+
+        auto span = MeasureLogBlockSpan<Store>(size);
+
+        memcpy(block_, &header, sizeof(header));
+        memset(encoded + size, 0xFF, span - sizeof(header) - size);
+
+        if (size_ > 0 && size_ + span > Store::SEGMENT_SIZE)
+        {
+            rotate();
+        }
+
+        if (!store_.write(last_, size_, block_, span))
+        {
+            return failure({
+                .context = "MeasureLog",
+                .message = "Failed to write the block",
+            });
+        }
+
+        size_ += span;
+
+        return ok();
+    }
+
+    /**
+     * @brief Commits the appended blocks to the flash
+     */
+    auto sync() -> void
+    {
+        store_.sync();
+    }
+
+    /**
+     * @brief Marks every measure before a position as delivered, reclaiming its segments
+     *
+     * @param position the position following the last delivered measure
+     *
+     * @return ErrorOr<> can be ok() or failure()
+     */
+    auto acknowledge(const MeasureLogPosition &position) -> ErrorOr<>
+    {
+        acknowledged_ = position;
+
+        while (first_ < acknowledged_.segment && first_ < last_)
+        {
+            store_.remove(first_);
+            first_++;
+        }
+
+        return saveAcknowledgement();
+    }
+
+    // Returns the position following the last delivered measure.
+    auto acknowledged() const -> MeasureLogPosition { return acknowledged_; }
+
+    // Returns the oldest segment.
+    auto first() const -> uint32_t { return first_; }
+
+    // Returns the position of the next appended block.
+    auto head() const -> MeasureLogPosition { return {.segment = last_, .offset = size_}; }
+
+    // Returns the number of undelivered segments dropped to bound the log.
+    auto lost() const -> uint32_t { return lost_; }
+
+    auto store() -> Store & { return store_; }
+
+private:
+    // Drops what follows the last valid block of a segment and returns its size.
+    auto recover(uint32_t segment) -> uint32_t
+    {
+        uint32_t offset = 0;
+        MeasureLogBlockHeader header;
+
+        while (ReadMeasureLogBlockHeader(store_, segment, offset, header))
+        {
+            MeasureBlockSource<Store> source(store_, segment, offset + sizeof(header), header.size);
+
+            if (source.crc() != header.crc || !source.atEnd())
+            {
+                break;
+            }
+
+            offset += MeasureLogBlockSpan<Store>(header.size);
+        }
+
+        if (!store_.truncate(segment, offset))
+        {
+            // the next block goes to a new segment.
+            LOG_WARN(STORAGE) << "MeasureLog: closing segment " << (unsigned long)segment << " after a torn block";
+            return Store::SEGMENT_SIZE;
+        }
+
+        return offset;
+    }
+
+    // Starts a new segment, dropping the oldest ones beyond MEASURE_LOG_MAX_SEGMENTS.
+    auto rotate() -> void
+    {
+        last_++;
+        size_ = 0;
+
+        while (last_ - first_ + 1 > MEASURE_LOG_MAX_SEGMENTS)
+        {
+            store_.remove(first_);
+
+            if (acknowledged_.segment <= first_)
+            {
+                acknowledged_ = {.segment = first_ + 1};
+                lost_++;
+            }
+
+            first_++;
+        }
+    }
+
+    auto loadAcknowledgement() -> void
+    {
+        acknowledged_ = {.segment = first_};
+
+        RecoverAtomicWrite(MEASURE_LOG_ACK_FILE);
+
+        File file = LittleFS.open(MEASURE_LOG_ACK_FILE, "r");
+
+        if (!file)
+        {
+            return;
+        }
+
+        MeasureLogPosition position;
+        uint32_t crc;
+
+        if (file.read(reinterpret_cast<uint8_t *>(&position), sizeof(position)) == sizeof(position) &&
+            file.read(reinterpret_cast<uint8_t *>(&crc), sizeof(crc)) == sizeof(crc) &&
+            utility::crc32(&position, sizeof(position)) == crc &&
+            position.segment >= first_ && position.segment <= last_)
+        {
+            acknowledged_ = position;
+        }
+
+        file.close();
+    }
+
+    auto saveAcknowledgement() -> ErrorOr<>
+    {
+        struct
+        {
+            MeasureLogPosition position;
+            uint32_t crc;
+        } record = {acknowledged_, utility::crc32(&acknowledged_, sizeof(acknowledged_))};
+
+        return WriteFileAtomically(MEASURE_LOG_ACK_FILE, reinterpret_cast<const uint8_t *>(&record), sizeof(record));
+    }
+
+    bool open_ = false;
+
+    // Oldest and newest segments, and size of the newest one.
+    uint32_t first_ = 1;
+    uint32_t last_ = 1;
+    uint32_t size_ = 0;
+
+    MeasureLogPosition acknowledged_;
+
+    Store store_;
+
+    // Block being encoded, behind its header.
+    uint8_t block_[MeasureLogBlockSpan<Store>(MEASURE_BLOCK_MAX_SIZE)] __attribute__((aligned(4)));
+
+    uint32_t lost_ = 0;
+};
+
+/**
+ * @brief Reads the measures of a log one at a time
+ * @details Holds a single decoded block, so reading the log costs the same memory whatever
+ * its backlog. Blocks are streamed from the flash through MEASURE_LOG_READ_BUFFER_SIZE bytes.
+ *
+ * For example:
+ *   MeasureCursor cursor(log);
+ *   while (cursor.next(measure)) { ... }
+ *   log.acknowledge(cursor.position());
+ */
+template <typename Store>
+class BasicMeasureCursor
+{
+public:
+    /**
+     * @brief Creates a cursor on the first measure not delivered yet
+     */
+    explicit BasicMeasureCursor(BasicMeasureLog<Store> &log) : log_(log)
+    {
+        seek(log.acknowledged());
+    }
+
+    /**
+     * @brief Moves to a position, e.g. one saved to resume a previous read
+     */
+    auto seek(const MeasureLogPosition &position) -> void
+    {
+        position_ = position;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Reads the measure at the position of the cursor
+     * @details Skips the blocks that fail their CRC or their decoding.
+     *
+     * @param measure receives the measure
+     *
+     * @return bool false at the end of the log.
+     */
+    auto next(Measure &measure) -> bool
+    {
+        if (position_.segment < log_.first())
+        {
+            seek({.segment = log_.first()});
+        }
+
+        auto head = log_.head();
+
+        while (position_.segment < head.segment || (position_.segment == head.segment && position_.offset < head.offset))
+        {
+            if (!load())
+            {
+                // a closed segment ends early after a recovery.
+                seek({.segment = position_.segment + 1});
+                continue;
+            }
+
+            // past the block, or a block that failed.
+            if (position_.record >= length_)
+            {
+                seek({.segment = position_.segment, .offset = position_.offset + size_});
+                continue;
+            }
+
+            measure = measures_[position_.record++];
+
+            // the position after the last measure of a block is the start of the next one.
+            if (position_.record == length_)
+            {
+                seek({.segment = position_.segment, .offset = position_.offset + size_});
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // Returns the position of the next measure.
+    auto position() const -> MeasureLogPosition { return position_; }
+
+    // Returns the number of blocks skipped because their CRC or their decoding failed.
+    auto skipped() const -> uint32_t { return skipped_; }
+
+private:
+    // Decodes the block at the position unless it is already loaded.
+    auto load() -> bool
+    {
+        if (size_ > 0)
+        {
+            return true;
+        }
+
+        // the appended blocks are only visible to a reader once committed.
+        if (position_.segment == log_.head().segment)
+        {
+            log_.sync();
+        }
+
+        auto &store = log_.store();
+        MeasureLogBlockHeader header;
+
+        if (!ReadMeasureLogBlockHeader(store, position_.segment, position_.offset, header))
+        {
+            return false;
+        }
+
+        utility::BasicVarintReader<MeasureBlockSource<Store>> reader(store, position_.segment, position_.offset + sizeof(header), header.size);
+
+        auto decoded = DecodeMeasureBlock(reader, measures_, MEASURE_BLOCK_CAPACITY);
+
+        size_ = MeasureLogBlockSpan<Store>(header.size);
+        length_ = 0;
+
+        if (decoded.ok() && reader.source().crc() == header.crc)
+        {
+            length_ = *decoded;
+        }
+        else
+        {
+            skipped_++;
+        }
+
+        return true;
+    }
+
+    BasicMeasureLog<Store> &log_;
+    MeasureLogPosition position_;
+
+    // The block at the position, decoded, and its size on the segment. 0 until loaded.
+    Measure measures_[MEASURE_BLOCK_CAPACITY];
+    size_t length_ = 0;
+    uint32_t size_ = 0;
+
+    uint32_t skipped_ = 0;
+};
+
+typedef BasicMeasureLog<MeasureSegmentStore> MeasureLog;
+typedef BasicMeasureCursor<MeasureSegmentStore> MeasureCursor;
+
+/**
+ * @brief The log of the measures of the node.
+ */
+MeasureLog measureLog{MEASURE_SEGMENT_STORE_ARGS};
+
+/**
+ * @brief Imports the text file written before the measure log, then deletes it
+ * @details The file is only deleted once every measure of it is on the log. Otherwise it is
+ * imported again on the next boot, where the measures already appended are saved twice
+ * rather than lost.
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto ImportMeasureFile() -> ErrorOr<>
+{
+    if (!FileExists(MEASURE_FILE))
+    {
+        return ok();
+    }
+
+    Measure measures[MEASURE_BLOCK_CAPACITY];
+    size_t length = 0;
+    ErrorOr<> appendResult;
+
+    auto readResult = ReadLinesFromFile(MEASURE_FILE, '\n', [&](const FileLine &view) -> void
+                                        {
+                                            if (view.partial || !appendResult.ok())
+                                            {
+                                                return;
+                                            }
+
+                                            utility::Tokenizer tokens(utility::StringView(view.data, view.length).trim(), ';');
+                                            utility::StringView fields[5];
+                                            size_t count = 0;
+
+                                            while (count < 5 && tokens.next(fields[count]))
+                                            {
+                                                count++;
+                                            }
+
+                                            auto type = count > 1 ? MeasureTypeIndex(fields[1]) : -1;
+
+                                            if (type < 0)
+                                            {
+                                                return;
+                                            }
+
+                                            auto &reg = SOIL_REGISTERS[type];
+
+                                            uint32_t timestamp = 0;
+                                            uint32_t flags = MEASURE_FLAG_NONE;
+                                            uint32_t slave = MODBUS_SLAVE_ADDRESS;
+
+                                            // lines written before the multi-drop bus carry the value and the type only.
+                                            if (count > 2)
+                                            {
+                                                fields[2].toUInt(slave);
+                                            }
+
+                                            if (count > 3)
+                                            {
+                                                fields[3].toUInt(timestamp);
+                                            }
+
+                                            if (count > 4)
+                                            {
+                                                fields[4].toUInt(flags);
+                                            }
+
+                                            // a Modbus address is a single byte; anything larger is not a line written here.
+                                            if (slave > UINT8_MAX)
+                                            {
+                                                return;
+                                            }
+
+                                            measures[length++] = {
+                                                .timestamp = timestamp,
+                                                .value = ParseFixedPoint(fields[0], reg.decimals),
+                                                .parameter = reg.parameter,
+                                                .flags = static_cast<uint8_t>(flags),
+                                                .type = static_cast<uint8_t>(type),
+                                                .slave = static_cast<uint8_t>(slave),
+                                            };
+
+                                            if (length == MEASURE_BLOCK_CAPACITY)
+                                            {
+                                                appendResult = measureLog.append(measures, length);
+                                                length = 0;
+                                            }
+                                        });
+
+    if (!readResult.ok())
+    {
+        return readResult;
+    }
+
+    if (appendResult.ok() && length > 0)
+    {
+        appendResult = measureLog.append(measures, length);
+    }
+
+    measureLog.sync();
+
+    if (!appendResult.ok())
+    {
+        return appendResult;
+    }
+
+    return DeleteFile(MEASURE_FILE);
+}
+
+/**
+ * @brief Opens the measure log
+ * @details Must run once the file system is mounted.
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto OpenMeasureLog() -> ErrorOr<>
+{
+    auto result = measureLog.open();
+
+    if (!result.ok())
+    {
+        return result;
+    }
+
+    return ImportMeasureFile();
+}
+
+/**
+ * @brief Save measures on the log
+ *
+ * @param measures the measures to save
+ * @param length the number of measures
+ *
+ * @return ErrorOr<void>
+ */
+auto SaveMeasureOnFile(const Measure *measures, size_t length) -> ErrorOr<void>
+{
+    if (!measureLog.isOpen())
+    {
+        return failure({
+            .context = "SaveMeasureOnFile",
+            .message = "The measure log is not open",
+        });
+    }
+
+    for (size_t i = 0; i < length; i += MEASURE_BLOCK_CAPACITY)
+    {
+        auto count = length - i < MEASURE_BLOCK_CAPACITY ? length - i : MEASURE_BLOCK_CAPACITY;
+        auto result = measureLog.append(measures + i, count);
+
+        if (!result.ok())
+        {
+            measureLog.sync();
+            return result;
+        }
+    }
+
+    measureLog.sync();
+
+    return ok();
+}
+
+/**
+ * @brief Save the measure on the log
+ *
+ * @param measures the measures to save
+ *
+ * @return ErrorOr<void>
+ */
+auto SaveMeasureOnFile(const MeasureBatch &measures) -> ErrorOr<void>
+{
+    return SaveMeasureOnFile(measures.data(), measures.length());
+}
+
+#endif // ! _MeasureLog_h_
@@ -0,0 +1,419 @@
+/**
+ * @file measure-store.h
+ * @brief Storage of the segments of the measure log
+ * @details This file contains the stores the measure log keeps its segments in, chosen at
+ * compile time by MEASURE_STORAGE. A store reads and writes bytes of numbered segments and
+ * knows nothing of blocks or measures:
+ *
+ *   begin()                             prepares the storage
+ *   segments(first, last)               finds the oldest and newest segments, false if none
+ *   read(segment, offset, data, size)   returns the number of bytes read
+ *   write(segment, offset, data, size)  writes at the end of a segment, offset 0 starts it
+ *   truncate(segment, size)             drops the bytes past size, false if it cannot
+ *   remove(segment)                     drops a segment
+ *   sync()                              commits the writes
+ *
+ * SEGMENT_SIZE is the room of a segment, and writes are ALIGNMENT bytes aligned in offset
+ * and size.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MeasureStore_h_
+#define _MeasureStore_h_
+
+#include <config/file-system.h>
+#include <config/measure.h>
+#include <file.h>
+
+/**
+ * @brief Segments of the measure log as files of LittleFS
+ */
+class LittleFsSegmentStore
+{
+public:
+    static constexpr uint32_t SEGMENT_SIZE = MEASURE_LOG_SEGMENT_SIZE;
+    static constexpr uint32_t ALIGNMENT = 1;
+
+    auto begin() -> bool
+    {
+        // a handle of a previous open may see files since removed.
+        reader_.close();
+        readerStale_ = false;
+
+        return LittleFS.exists(MEASURE_LOG_DIR) || LittleFS.mkdir(MEASURE_LOG_DIR);
+    }
+
+    auto segments(uint32_t &first, uint32_t &last) -> bool
+    {
+        bool found = false;
+        auto dir = LittleFS.openDir(MEASURE_LOG_DIR);
+
+        while (dir.next())
+        {
+            auto name = dir.fileName();
+
+            // skips the acknowledgement file.
+            if (name.length() == 0 || name[0] < '0' || name[0] > '9')
+            {
+                continue;
+            }
+
+            uint32_t segment = name.toInt();
+
+            if (!found || segment < first)
+            {
+                first = segment;
+            }
+
+            if (!found || segment > last)
+            {
+                last = segment;
+            }
+
+            found = true;
+        }
+
+        return found;
+    }
+
+    auto read(uint32_t segment, uint32_t offset, uint8_t *data, size_t size) -> size_t
+    {
+        // a handle only sees the writes committed before it was opened.
+        if (!reader_ || readerSegment_ != segment || readerStale_)
+        {
+            reader_.close();
+            reader_ = LittleFS.open(SegmentPath(segment), "r");
+            readerSegment_ = segment;
+            readerStale_ = false;
+        }
+
+        if (!reader_ || !reader_.seek(offset))
+        {
+            return 0;
+        }
+
+        return reader_.read(data, size);
+    }
+
+    auto write(uint32_t segment, uint32_t offset, const uint8_t *data, size_t size) -> bool
+    {
+        (void)offset;
+
+        // the previous segment is complete.
+        if (writerSegment_ != segment)
+        {
+            fileHandles.close(SegmentPath(writerSegment_));
+            writerSegment_ = segment;
+        }
+
+        auto &writer = fileHandles.open(SegmentPath(segment), "a");
+
+        readerStale_ = readerStale_ || readerSegment_ == segment;
+
+        return writer && writer.write(data, size) == size;
+    }
+
+    auto truncate(uint32_t segment, uint32_t size) -> bool
+    {
+        File file = LittleFS.open(SegmentPath(segment), "r+");
+
+        if (!file)
+        {
+            return size == 0;
+        }
+
+        if (file.size() != size)
+        {
+            file.truncate(size);
+            readerStale_ = readerStale_ || readerSegment_ == segment;
+        }
+
+        file.close();
+
+        return true;
+    }
+
+    auto remove(uint32_t segment) -> void
+    {
+        if (readerSegment_ == segment)
+        {
+            reader_.close();
+        }
+
+        LittleFS.remove(SegmentPath(segment));
+    }
+
+    auto sync() -> void
+    {
+        fileHandles.flush();
+    }
+
+    static auto SegmentPath(uint32_t segment) -> String
+    {
+        return String(MEASURE_LOG_DIR) + "/" + segment;
+    }
+
+private:
+    File reader_;
+    uint32_t readerSegment_ = 0;
+    bool readerStale_ = false;
+
+    uint32_t writerSegment_ = 0;
+};
+
+/**
+ * @brief Marks a sector holding a segment of the flash ring.
+ */
+#define MEASURE_FLASH_SEGMENT_MAGIC 0x4D534547
+
+/**
+ * @brief The header at the start of each sector of the flash ring
+ */
+struct FlashSegmentHeader
+{
+    // MEASURE_FLASH_SEGMENT_MAGIC, 0xFFFFFFFF while erased, 0 once removed.
+    uint32_t magic;
+
+    // Number of the segment, growing by one on each new segment.
+    uint32_t segment;
+};
+
+/**
+ * @brief Segments of the measure log on a ring of raw flash sectors
+ * @details Segment n lives on sector n % MEASURE_LOG_MAX_SEGMENTS of the region at `start`.
+ * The log never keeps more segments than that, so a sector is only reused once its segment
+ * is dropped. A sector is erased when its segment starts, and its header carries the
+ * number of the segment, so the ring is found again at boot by scanning the headers.
+ * Flash bits only go from 1 to 0 until erased, so a torn write cannot be truncated.
+ *
+ * @tparam Flash the flash, with `static constexpr uint32_t SECTOR_SIZE`,
+ * `read(address, data, size) -> bool`, `write(address, data, size) -> bool` for 4 bytes
+ * aligned writes, and `erase(address) -> bool`. e.g. SpiFlash, or a flash in RAM on the host.
+ */
+template <typename Flash>
+class FlashRingSegmentStore
+{
+public:
+    static constexpr uint32_t SEGMENT_SIZE = Flash::SECTOR_SIZE - sizeof(FlashSegmentHeader);
+    static constexpr uint32_t ALIGNMENT = 4;
+
+    static_assert(sizeof(FlashSegmentHeader) % ALIGNMENT == 0, "The header must keep the writes aligned");
+
+    explicit FlashRingSegmentStore(uint32_t start) : start_(start) {}
+
+    auto begin() -> bool
+    {
+        return start_ % Flash::SECTOR_SIZE == 0;
+    }
+
+    auto segments(uint32_t &first, uint32_t &last) -> bool
+    {
+        bool found = false;
+
+        for (uint32_t sector = 0; sector < MEASURE_LOG_MAX_SEGMENTS; sector++)
+        {
+            FlashSegmentHeader header;
+
+            if (!flash_.read(start_ + sector * Flash::SECTOR_SIZE, &header, sizeof(header)) ||
+                header.magic != MEASURE_FLASH_SEGMENT_MAGIC ||
+                header.segment % MEASURE_LOG_MAX_SEGMENTS != sector)
+            {
+                continue;
+            }
+
+            if (!found || header.segment < first)
+            {
+                first = header.segment;
+            }
+
+            if (!found || header.segment > last)
+            {
+                last = header.segment;
+            }
+
+            found = true;
+        }
+
+        return found;
+    }
+
+    auto read(uint32_t segment, uint32_t offset, uint8_t *data, size_t size) -> size_t
+    {
+        if (offset >= SEGMENT_SIZE)
+        {
+            return 0;
+        }
+
+        if (size > SEGMENT_SIZE - offset)
+        {
+            size = SEGMENT_SIZE - offset;
+        }
+
+        return flash_.read(address(segment) + offset, data, size) ? size : 0;
+    }
+
+    auto write(uint32_t segment, uint32_t offset, const uint8_t *data, size_t size) -> bool
+    {
+        if (offset % ALIGNMENT != 0 || size % ALIGNMENT != 0 || offset + size > SEGMENT_SIZE)
+        {
+            return false;
+        }
+
+        if (offset == 0)
+        {
+            FlashSegmentHeader header = {.magic = MEASURE_FLASH_SEGMENT_MAGIC, .segment = segment};
+
+            if (!flash_.erase(sector(segment)) ||
+                !flash_.write(sector(segment), &header, sizeof(header)))
+            {
+                return false;
+            }
+        }
+
+        return flash_.write(address(segment) + offset, data, size);
+    }
+
+    // The bytes past `size` can only be left behind if they are still erased.
+    auto truncate(uint32_t segment, uint32_t size) -> bool
+    {
+        uint8_t buffer[64];
+
+        for (uint32_t offset = size; offset < SEGMENT_SIZE; offset += sizeof(buffer))
+        {
+            auto length = read(segment, offset, buffer, sizeof(buffer));
+
+            for (size_t i = 0; i < length; i++)
+            {
+                if (buffer[i] != 0xFF)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Zeroes the magic of the header, which needs no erase.
+    auto remove(uint32_t segment) -> void
+    {
+        uint32_t removed = 0;
+
+        flash_.write(sector(segment), &removed, sizeof(removed));
+    }
+
+    auto sync() -> void {}
+
+    auto flash() -> Flash & { return flash_; }
+
+private:
+    auto sector(uint32_t segment) const -> uint32_t
+    {
+        return start_ + (segment % MEASURE_LOG_MAX_SEGMENTS) * Flash::SECTOR_SIZE;
+    }
+
+    auto address(uint32_t segment) const -> uint32_t
+    {
+        return sector(segment) + sizeof(FlashSegmentHeader);
+    }
+
+    Flash flash_;
+    uint32_t start_;
+};
+
+#if MEASURE_STORAGE == MEASURE_STORAGE_LITTLEFS
+
+typedef LittleFsSegmentStore MeasureSegmentStore;
+
+#define MEASURE_SEGMENT_STORE_ARGS
+
+#elif MEASURE_STORAGE == MEASURE_STORAGE_FLASH_RING
+
+#ifndef MEASURE_FLASH_START
+#error "MEASURE_FLASH_START must point at a flash region kept out of the sketch and the file system"
+#endif // ! MEASURE_FLASH_START
+
+extern "C"
+{
+#include <spi_flash.h>
+}
+
+/**
+ * @brief The flash of the ESP8266, through the SDK
+ * @details The SDK reads and writes 4 bytes aligned words from 4 bytes aligned buffers, so
+ * the bytes go through a buffer of words.
+ */
+class SpiFlash
+{
+public:
+    static constexpr uint32_t SECTOR_SIZE = SPI_FLASH_SEC_SIZE;
+
+    auto read(uint32_t address, void *data, size_t size) -> bool
+    {
+        auto out = static_cast<uint8_t *>(data);
+
+        while (size > 0)
+        {
+            uint32_t aligned = address & ~3u;
+            uint32_t skip = address - aligned;
+            size_t length = size < sizeof(words_) - skip ? size : sizeof(words_) - skip;
+
+            if (spi_flash_read(aligned, words_, (skip + length + 3) & ~3u) != SPI_FLASH_RESULT_OK)
+            {
+                return false;
+            }
+
+            memcpy(out, reinterpret_cast<uint8_t *>(words_) + skip, length);
+
+            out += length;
+            address += length;
+            size -= length;
+        }
+
+        return true;
+    }
+
+    auto write(uint32_t address, const void *data, size_t size) -> bool
+    {
+        auto in = static_cast<const uint8_t *>(data);
+
+        while (size > 0)
+        {
+            size_t length = size < sizeof(words_) ? size : sizeof(words_);
+
+            memcpy(words_, in, length);
+
+            if (spi_flash_write(address, words_, length) != SPI_FLASH_RESULT_OK)
+            {
+                return false;
+            }
+
+            in += length;
+            address += length;
+            size -= length;
+        }
+
+        return true;
+    }
+
+    auto erase(uint32_t address) -> bool
+    {
+        return spi_flash_erase_sector(address / SECTOR_SIZE) == SPI_FLASH_RESULT_OK;
+    }
+
+private:
+    uint32_t words_[16];
+};
+
+typedef FlashRingSegmentStore<SpiFlash> MeasureSegmentStore;
+
+#define MEASURE_SEGMENT_STORE_ARGS MEASURE_FLASH_START
+
+#else
+#error "MEASURE_STORAGE must be MEASURE_STORAGE_LITTLEFS or MEASURE_STORAGE_FLASH_RING"
+#endif // ! MEASURE_STORAGE
+
+#endif // ! _MeasureStore_h_
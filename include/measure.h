@@ -1,6 +1,9 @@
 /**
  * @file read-measure.h
- * @brief Read the measure from the sensor and save it on the file
+ * @brief The measure of a sensor
+ * @details A measure is a fixed-size record holding the raw fixed-point value of a register.
+ * Values and type names are only formatted when a measure leaves the node, so taking a
+ * measure does not touch the heap.
  * @author Higor Grigorio <higorgrigorio@gmail.com>
  * @date 2023-07-10
  * @version 1.0.0
@@ -8,109 +11,205 @@
 #ifndef _Measure_h_
 #define _Measure_h_
 
-#include <config/file-system.h>
-#include <file.h>
+#include <sensor-typing.h>
+#include <modbus-register-map.h>
+#include <modbus-slaves.h>
+
+#include <time.h>
+
+#include <StaticVector.h>
+#include <StringView.h>
+
+/**
+ * @brief Smallest timestamp read from a synced clock, 2020-01-01.
+ */
+#define MEASURE_EPOCH_MIN 1577836800
 
-#include <StringHelper.h>
+/**
+ * @brief The quality flags of a measure
+ */
+enum MeasureFlag : uint8_t
+{
+    MEASURE_FLAG_NONE = 0,
+    // The clock was not synced, the timestamp counts seconds since boot.
+    MEASURE_FLAG_UPTIME = 1 << 0,
+    // First measure of the filter, the moving average has not settled.
+    MEASURE_FLAG_FIRST = 1 << 1,
+    // The slave was considered dead before this measure.
+    MEASURE_FLAG_RECOVERED = 1 << 2,
+};
 
 /**
  * @brief The measure of a sensor
  */
 struct Measure
 {
-    String value;
-    String idType;
+    // Seconds since the epoch, or since boot with MEASURE_FLAG_UPTIME.
+    uint32_t timestamp;
+
+    // Raw value of the register, with the decimals of its type.
+    int32_t value;
+
+    SoilParameter parameter;
+
+    // Bitmask of MeasureFlag.
+    uint8_t flags;
+
+    // Index of the type on SOIL_REGISTERS.
+    uint8_t type;
+
+    // Address of the probe that took the measure.
+    uint8_t slave;
 };
 
+static_assert(std::is_trivially_copyable<Measure>::value, "Measure must be trivially copyable");
+static_assert(sizeof(Measure) == 12, "Measure must stay compact");
+
 /**
- * @brief Save the measure on the file
+ * @brief Largest number of measures taken on a round over the slaves.
+ */
+constexpr size_t MEASURE_BATCH_CAPACITY = MODBUS_SLAVES_LENGTH * SOIL_REGISTERS_LENGTH;
+
+static_assert(DEVICE_CONFIG_TYPES_CAPACITY >= MEASURE_BATCH_CAPACITY, "The device configuration must keep a credential per measure of a batch");
+
+/**
+ * @brief The measures of a round over the slaves
+ * @details Kept inline, so a round never touches the heap. add() returns false once full.
+ */
+using MeasureBatch = utility::StaticVector<Measure, MEASURE_BATCH_CAPACITY>;
+
+/**
+ * @brief Get the current timestamp of a measure
  *
- * @param measures the measures to save
+ * @param flags receives MEASURE_FLAG_UPTIME if the clock is not synced
  *
- * @return ErrorOr<void>
+ * @return uint32_t the timestamp, in seconds
  */
-auto SaveMeasureOnFile(const LL<Measure> &measures) -> ErrorOr<void>
+auto MeasureTimestamp(uint8_t &flags) -> uint32_t
 {
-    ErrorOr<> result;
+    time_t now = time(nullptr);
 
-    if (!FileExists(MEASURE_FILE))
+    if (now < MEASURE_EPOCH_MIN)
     {
-        CreateFile(MEASURE_FILE);
+        flags |= MEASURE_FLAG_UPTIME;
+        return millis() / 1000;
     }
 
-    auto openResult = OpenFile(MEASURE_FILE, "w");
+    return now;
+}
+
+/**
+ * @brief Formats a fixed-point register value
+ *
+ * @param raw the raw value
+ * @param decimals the number of decimal places of the raw value
+ *
+ * @return String the formatted value, e.g. 235 with 1 decimal is "23.5"
+ */
+auto FormatFixedPoint(int32_t raw, uint8_t decimals) -> String
+{
+    String result = raw < 0 ? "-" : "";
+    uint32_t magnitude = raw < 0 ? -raw : raw;
+    uint32_t divisor = 1;
 
-    if (!openResult.ok())
+    for (uint8_t i = 0; i < decimals; i++)
     {
-        result = failure(openResult.error());
+        divisor *= 10;
     }
-    else
+
+    result += magnitude / divisor;
+
+    if (decimals > 0)
     {
-        auto file = openResult.unwrap();
+        String fraction = String(magnitude % divisor);
 
-        for (auto measure : measures)
+        result += ".";
+
+        for (auto i = fraction.length(); i < decimals; i++)
         {
-            auto line = String(measure.value) + ";" + measure.idType;
-            file.println(line);
+            result += "0";
         }
 
-        file.close();
+        result += fraction;
     }
 
     return result;
 }
 
 /**
- * @brief Read the measure from the file
+ * @brief Parses a value formatted by FormatFixedPoint()
+ *
+ * @param text the formatted value
+ * @param decimals the number of decimal places of the raw value
  *
- * @return ErrorOr<LL<Measure>> list of measures.
+ * @return int32_t the raw value, extra decimal places are truncated
  */
-auto ReadMeasureFromFile() -> ErrorOr<LL<Measure>>
+auto ParseFixedPoint(utility::StringView text, uint8_t decimals) -> int32_t
 {
-    ErrorOr<LL<Measure>> result;
+    int32_t result = 0;
+    bool negative = false;
+    bool fraction = false;
+    uint8_t places = 0;
 
-    if (IsEmptyFile(MEASURE_FILE))
+    for (char c : text)
     {
-        result = failure({
-            .context = "ReadMeasureFromFile",
-            .message = "File is empty",
-        });
+        if (c == '-')
+        {
+            negative = true;
+        }
+        else if (c == '.')
+        {
+            fraction = true;
+        }
+        else if (c >= '0' && c <= '9' && (!fraction || places < decimals))
+        {
+            result = result * 10 + (c - '0');
+            places += fraction;
+        }
     }
-    else
+
+    for (; places < decimals; places++)
     {
-        auto readResult = ReadFromFile(MEASURE_FILE, '\n');
+        result *= 10;
+    }
 
-        if (!readResult.ok())
-        {
-            result = failure(readResult.error());
-        }
-        else
+    return negative ? -result : result;
+}
+
+/**
+ * @brief Get the name of the type of a measure, e.g. "temperature"
+ */
+auto MeasureTypeName(const Measure &measure) -> const char *
+{
+    return SOIL_REGISTERS[measure.type].type;
+}
+
+/**
+ * @brief Get the index of a type on SOIL_REGISTERS
+ *
+ * @param name the name of the type
+ *
+ * @return int the index, or -1 if the type is unknown.
+ */
+auto MeasureTypeIndex(utility::StringView name) -> int
+{
+    for (size_t i = 0; i < SOIL_REGISTERS_LENGTH; i++)
+    {
+        if (name.equals(SOIL_REGISTERS[i].type))
         {
-            auto lines = readResult.unwrap();
-            auto measures = LL<Measure>();
-
-            for (auto line : lines)
-            {
-                auto splitResult = utility::StringHelper::splitStringToArray(line, ';');
-
-                if (splitResult.ok())
-                {
-                    auto array = splitResult.unwrap();
-                    auto value = array.at(0)->substring(0, array.at(0)->length() - 1);
-                    auto idType = array.at(1)->substring(1, array.at(1)->length() - 1);
-
-                    measures.add({
-                        .value = value,
-                        .idType = idType,
-                    });
-                }
-            }
-
-            result = ok(measures);
+            return i;
         }
     }
 
-    return result;
+    return -1;
+}
+
+/**
+ * @brief Formats the value of a measure, e.g. "23.5"
+ */
+auto MeasureValueToString(const Measure &measure) -> String
+{
+    return FormatFixedPoint(measure.value, SOIL_REGISTERS[measure.type].decimals);
 }
 
 /**
@@ -120,13 +219,13 @@ auto ReadMeasureFromFile() -> ErrorOr<LL<Measure>>
  *
  * @return String the string
  */
-auto ListOfMeasureToString(const LL<Measure> &measures) -> String
+auto ListOfMeasureToString(const MeasureBatch &measures) -> String
 {
     String result = "";
 
-    for (auto measure : measures)
+    for (auto &measure : measures)
     {
-        result += measure.value + "," + measure.idType + ";";
+        result += MeasureValueToString(measure) + "," + SensorTypeKey(measure.slave, MeasureTypeName(measure)) + ";";
     }
 
     return result;
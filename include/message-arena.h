@@ -0,0 +1,26 @@
+/**
+ * @file message-arena.h
+ * @brief Arena of the messages
+ * @details This file contains the arena the broker messages are handled on. A handler opens a
+ * utility::ArenaScope, and the texts copied out of a payload and the bodies published are
+ * allocated on the arena, then all freed at once when the scope ends, instead of one by one
+ * on the heap. highWater() tells how much of MESSAGE_ARENA_SIZE the messages need.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _MessageArena_h_
+#define _MessageArena_h_
+
+#include <config/system.h>
+
+#include <Arena.h>
+
+/**
+ * @brief The arena of the messages.
+ */
+utility::StaticArena<MESSAGE_ARENA_SIZE> messageArena;
+
+#endif // ! _MessageArena_h_
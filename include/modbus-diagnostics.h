@@ -0,0 +1,175 @@
+/**
+ * @file modbus-diagnostics.h
+ * @brief Modbus timing diagnostics
+ * @details This file contains the timestamps taken along a Modbus transaction and the fixed
+ * bucket histograms they are accumulated into. Recording a sample is a handful of integer
+ * operations, so the histograms stay on in production.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusDiagnostics_h_
+#define _ModbusDiagnostics_h_
+
+#include <Arduino.h>
+
+/**
+ * @brief Number of buckets of a timing histogram.
+ * @details Bucket `i` counts durations in [2^i, 2^(i+1)) microseconds, the last one is open.
+ * 20 buckets reach half a second.
+ */
+#ifndef MODBUS_HISTOGRAM_BUCKETS
+#define MODBUS_HISTOGRAM_BUCKETS 20
+#endif // ! MODBUS_HISTOGRAM_BUCKETS
+
+/**
+ * @brief The instants of a transaction, in CPU cycles.
+ * @details Arrivals are stamped when poll() sees them, so their resolution is the period of loop().
+ */
+struct ModbusTiming
+{
+    // The request was handed to the transport.
+    uint32_t sentAt = 0;
+    // The request left the wire and the driver was released.
+    uint32_t transmittedAt = 0;
+    uint32_t firstByteAt = 0;
+    uint32_t lastByteAt = 0;
+    // The response was validated and decoded.
+    uint32_t decodedAt = 0;
+};
+
+/**
+ * @brief Converts a number of CPU cycles to microseconds
+ */
+auto CyclesToMicros(uint32_t cycles) -> uint32_t
+{
+    return cycles / ESP.getCpuFreqMHz();
+}
+
+/**
+ * @brief A histogram of durations with power of two buckets
+ */
+class TimingHistogram
+{
+public:
+    /**
+     * @brief Adds a sample
+     *
+     * @param micros the duration in microseconds
+     */
+    auto add(uint32_t micros) -> void
+    {
+        size_t bucket = micros == 0 ? 0 : 31 - __builtin_clz(micros);
+
+        if (bucket >= MODBUS_HISTOGRAM_BUCKETS)
+        {
+            bucket = MODBUS_HISTOGRAM_BUCKETS - 1;
+        }
+
+        // saturates instead of wrapping.
+        if (counts_[bucket] != UINT16_MAX)
+        {
+            counts_[bucket]++;
+        }
+
+        if (samples_ == 0 || micros < min_)
+        {
+            min_ = micros;
+        }
+
+        if (micros > max_)
+        {
+            max_ = micros;
+        }
+
+        samples_++;
+        total_ += micros;
+    }
+
+    auto count(size_t bucket) const -> uint16_t { return counts_[bucket]; }
+
+    auto samples() const -> uint32_t { return samples_; }
+
+    auto min() const -> uint32_t { return min_; }
+
+    auto max() const -> uint32_t { return max_; }
+
+    auto mean() const -> uint32_t { return samples_ == 0 ? 0 : total_ / samples_; }
+
+    auto reset() -> void { *this = TimingHistogram(); }
+
+    /**
+     * @brief Formats the histogram, e.g. "n=10 min=40 mean=52 max=90 [5:3 6:7]"
+     */
+    auto toString() const -> String
+    {
+        String result = String("n=") + samples_ +
+                        " min=" + min_ +
+                        " mean=" + mean() +
+                        " max=" + max_ + " [";
+
+        bool first = true;
+
+        for (size_t i = 0; i < MODBUS_HISTOGRAM_BUCKETS; i++)
+        {
+            if (counts_[i] == 0)
+            {
+                continue;
+            }
+
+            result += (first ? "" : " ") + String(i) + ":" + counts_[i];
+            first = false;
+        }
+
+        return result + "]";
+    }
+
+private:
+    uint16_t counts_[MODBUS_HISTOGRAM_BUCKETS] = {};
+    uint32_t samples_ = 0;
+    uint32_t min_ = 0;
+    uint32_t max_ = 0;
+    uint64_t total_ = 0;
+};
+
+/**
+ * @brief The timing histograms of a register group
+ */
+struct ModbusGroupDiagnostics
+{
+    // Shifting the request out.
+    TimingHistogram transmit;
+    // Waiting for the probe to answer.
+    TimingHistogram turnaround;
+    // Receiving the response on the bus.
+    TimingHistogram receive;
+    // Validating and decoding the response in the firmware.
+    TimingHistogram decode;
+    // From the request to the decoded values.
+    TimingHistogram total;
+
+    /**
+     * @brief Accumulates the timing of a successful transaction
+     */
+    auto add(const ModbusTiming &timing) -> void
+    {
+        transmit.add(CyclesToMicros(timing.transmittedAt - timing.sentAt));
+        turnaround.add(CyclesToMicros(timing.firstByteAt - timing.transmittedAt));
+        receive.add(CyclesToMicros(timing.lastByteAt - timing.firstByteAt));
+        decode.add(CyclesToMicros(timing.decodedAt - timing.lastByteAt));
+        total.add(CyclesToMicros(timing.decodedAt - timing.sentAt));
+    }
+
+    auto toString() const -> String
+    {
+        return String("transmit{") + transmit.toString() + "} " +
+               "turnaround{" + turnaround.toString() + "} " +
+               "receive{" + receive.toString() + "} " +
+               "decode{" + decode.toString() + "} " +
+               "total{" + total.toString() + "}";
+    }
+};
+
+#endif // ! _ModbusDiagnostics_h_
@@ -0,0 +1,123 @@
+/**
+ * @file modbus-frame.h
+ * @brief Modbus RTU request frames
+ * @details This file contains the constexpr builder of Modbus RTU request frames and its CRC16.
+ * Frames known at compile time are fully computed by the compiler.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-21
+ *
+ */
+
+#ifndef _ModbusFrame_h_
+#define _ModbusFrame_h_
+
+#include <c_types.h>
+#include <stddef.h>
+
+/**
+ * @brief Function code to read holding registers.
+ */
+#define MODBUS_READ_HOLDING_REGISTERS 0x03
+
+/**
+ * @brief Size of a request frame.
+ */
+#define MODBUS_REQUEST_SIZE 8
+
+/**
+ * @brief Computes the Modbus CRC16 of a buffer
+ *
+ * @param buffer the bytes
+ * @param length the number of bytes
+ *
+ * @return uint16_t the CRC, low byte first on the wire. Zero when the buffer ends with its own CRC.
+ */
+constexpr auto ModbusCrc16(const uint8_t *buffer, size_t length) -> uint16_t
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= buffer[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief A request frame: address, function, start register, register count and CRC
+ */
+struct ModbusRequestFrame
+{
+    uint8_t bytes[MODBUS_REQUEST_SIZE] = {};
+
+    constexpr auto size() const -> size_t { return MODBUS_REQUEST_SIZE; }
+
+    constexpr auto valid() const -> bool { return ModbusCrc16(bytes, MODBUS_REQUEST_SIZE) == 0; }
+
+    constexpr auto equals(const uint8_t (&other)[MODBUS_REQUEST_SIZE]) const -> bool
+    {
+        for (size_t i = 0; i < MODBUS_REQUEST_SIZE; i++)
+        {
+            if (bytes[i] != other[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Builds a request frame
+ *
+ * @param slave the slave address
+ * @param function the function code
+ * @param start the first register
+ * @param count the number of registers
+ *
+ * @return ModbusRequestFrame the frame, with its CRC
+ */
+constexpr auto ModbusBuildRequest(uint8_t slave, uint8_t function, uint16_t start, uint16_t count) -> ModbusRequestFrame
+{
+    ModbusRequestFrame frame;
+
+    frame.bytes[0] = slave;
+    frame.bytes[1] = function;
+    frame.bytes[2] = start >> 8;
+    frame.bytes[3] = start & 0xFF;
+    frame.bytes[4] = count >> 8;
+    frame.bytes[5] = count & 0xFF;
+
+    auto crc = ModbusCrc16(frame.bytes, 6);
+
+    frame.bytes[6] = crc & 0xFF;
+    frame.bytes[7] = crc >> 8;
+
+    return frame;
+}
+
+/**
+ * @brief A request frame computed at compile time
+ *
+ * For example:
+ *   constexpr auto WATER = ModbusFrame<0x01, MODBUS_READ_HOLDING_REGISTERS, 0x0201, 1>::value;
+ */
+template <uint8_t Slave, uint8_t Function, uint16_t Start, uint16_t Count>
+struct ModbusFrame
+{
+    static_assert(Slave > 0 && Slave < 248, "Modbus slave address must be in 1..247");
+    static_assert(Count > 0 && Count <= 125, "Modbus reads must request 1..125 registers");
+
+    static constexpr ModbusRequestFrame value = ModbusBuildRequest(Slave, Function, Start, Count);
+
+    static_assert(value.valid(), "Modbus frame CRC mismatch");
+};
+
+#endif // ! _ModbusFrame_h_
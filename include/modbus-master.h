@@ -0,0 +1,341 @@
+/**
+ * @file modbus-master.h
+ * @brief Modbus RTU master
+ * @details This file contains the non-blocking transaction engine to read holding registers
+ * from a Modbus RTU slave. The transaction is advanced by `poll()` from `loop()`, so the rest
+ * of the firmware keeps running while the slave answers.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusMaster_h_
+#define _ModbusMaster_h_
+
+#include <Arduino.h>
+
+#include <ErrorOr.h>
+
+#include <modbus-diagnostics.h>
+#include <modbus-frame.h>
+#include <modbus-register-map.h>
+#include <modbus-response.h>
+#include <rs485-transport.h>
+
+/**
+ * @brief Size of the largest read response frame: address, function, byte count, data and CRC.
+ */
+#define MODBUS_MAX_RESPONSE_SIZE (5 + 2 * MODBUS_MAX_REGISTERS_PER_READ)
+
+/**
+ * @brief Size of an exception response frame: address, function, exception code and CRC.
+ */
+#define MODBUS_EXCEPTION_SIZE 5
+
+/**
+ * @brief Computes the silent interval that ends a frame, 3.5 characters of 11 bits.
+ *
+ * @param baudRate the baud rate of the bus
+ *
+ * @return uint32_t the interval in microseconds. Fixed at 1750us above 19200 baud.
+ */
+constexpr auto ModbusSilenceMicros(uint32_t baudRate) -> uint32_t
+{
+    return baudRate > 19200 ? 1750 : 38500000UL / baudRate;
+}
+
+/**
+ * @brief The states of a Modbus transaction
+ */
+enum class ModbusState : uint8_t
+{
+    // No transaction started.
+    Idle,
+    // The request is being shifted out, the driver is enabled.
+    Transmitting,
+    // The driver is released, waiting for the first byte of the response.
+    Turnaround,
+    // The response is arriving, it ends on the expected length or 3.5 characters of silence.
+    Receiving,
+    // The request failed and is repeated after a backoff.
+    Backoff,
+    Done,
+    Error,
+};
+
+/**
+ * @brief Counters of the transactions of a bus
+ */
+struct ModbusStatistics
+{
+    uint32_t transactions = 0;
+    uint32_t crcFailures = 0;
+    uint32_t timeouts = 0;
+    uint32_t exceptions = 0;
+    // Responses rejected for any other fault: address, function, byte count or length.
+    uint32_t malformed = 0;
+    uint32_t retries = 0;
+    // Transactions given up after the retries.
+    uint32_t failures = 0;
+};
+
+/**
+ * @brief A read holding registers transaction
+ * @details Every response is validated against its request. Transient faults are retried up
+ * to MODBUS_MAX_RETRIES times, with a backoff doubled from MODBUS_RETRY_BACKOFF_MS.
+ *
+ * For example:
+ *   transaction.begin(0x01, 0x0200, 7);
+ *   // on loop()
+ *   if (transaction.poll() == ModbusState::Done) { auto value = transaction.value(0); }
+ */
+class ModbusTransaction
+{
+public:
+    typedef void (*Callback)(ModbusTransaction &transaction);
+
+    ModbusTransaction(Rs485Transport &transport, uint32_t baudRate)
+        : transport_(transport),
+          silence_(ModbusSilenceMicros(baudRate)) {}
+
+    /**
+     * @brief Starts a transaction
+     *
+     * @param slave the slave address
+     * @param start the first register
+     * @param count the number of registers, up to MODBUS_MAX_REGISTERS_PER_READ
+     * @param retries the number of times a transient failure is repeated
+     *
+     * @return bool false if a transaction is in progress or the count is invalid.
+     */
+    auto begin(uint8_t slave, uint16_t start, uint16_t count, uint8_t retries = MODBUS_MAX_RETRIES) -> bool
+    {
+        if (busy() || count == 0 || count > MODBUS_MAX_REGISTERS_PER_READ)
+        {
+            return false;
+        }
+
+        request_ = ModbusBuildRequest(slave, MODBUS_READ_HOLDING_REGISTERS, start, count);
+        count_ = count;
+        attempts_ = 0;
+        retries_ = retries;
+        error_ = Error::None;
+
+        statistics_.transactions++;
+
+        send();
+
+        return true;
+    }
+
+    /**
+     * @brief Advances the transaction without blocking
+     *
+     * @return ModbusState the current state
+     */
+    auto poll() -> ModbusState
+    {
+        switch (state_)
+        {
+        case ModbusState::Transmitting:
+            if (transport_.transmitted())
+            {
+                timing_.transmittedAt = ESP.getCycleCount();
+                startedAt_ = millis();
+                state_ = ModbusState::Turnaround;
+            }
+            break;
+
+        case ModbusState::Turnaround:
+            if (transport_.available() > 0)
+            {
+                timing_.firstByteAt = ESP.getCycleCount();
+                state_ = ModbusState::Receiving;
+                receive();
+            }
+            else if (millis() - startedAt_ >= MODBUS_RESPONSE_TIMEOUT_MS)
+            {
+                reject(ModbusFault::Timeout);
+            }
+            break;
+
+        case ModbusState::Receiving:
+            receive();
+
+            if (received_ >= expected())
+            {
+                complete(ModbusCheckResponse(response_, received_, request_));
+            }
+            else if (micros() - lastByteAt_ >= silence_)
+            {
+                complete(ModbusFault::Incomplete);
+            }
+            break;
+
+        case ModbusState::Backoff:
+            if (millis() - startedAt_ >= backoff_)
+            {
+                send();
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        return state_;
+    }
+
+    /**
+     * @brief Registers the function called once when the transaction is done or failed
+     */
+    auto onComplete(Callback callback) -> void { callback_ = callback; }
+
+    auto state() const -> ModbusState { return state_; }
+
+    auto busy() const -> bool
+    {
+        return state_ == ModbusState::Transmitting ||
+               state_ == ModbusState::Turnaround ||
+               state_ == ModbusState::Receiving ||
+               state_ == ModbusState::Backoff;
+    }
+
+    auto statistics() const -> const ModbusStatistics & { return statistics_; }
+
+    // Returns the instants of the last attempt. `decodedAt` is left to the consumer.
+    auto timing() const -> const ModbusTiming & { return timing_; }
+
+    // Returns the failure of the transaction.
+    // REQUIRES: `state()` is ModbusState::Error.
+    auto error() const -> Error { return error_; }
+
+    // Returns a register of the response, relative to the first requested one.
+    // REQUIRES: `state()` is ModbusState::Done.
+    auto value(uint16_t index) const -> uint16_t
+    {
+        return (response_[3 + 2 * index] << 8) | response_[4 + 2 * index];
+    }
+
+private:
+    // Number of bytes of the response being received.
+    auto expected() const -> size_t
+    {
+        if (received_ >= 2 && (response_[1] & 0x80))
+        {
+            return MODBUS_EXCEPTION_SIZE;
+        }
+        return 5 + 2 * count_;
+    }
+
+    auto receive() -> void
+    {
+        while (transport_.available() > 0 && received_ < MODBUS_MAX_RESPONSE_SIZE)
+        {
+            response_[received_++] = transport_.read();
+            lastByteAt_ = micros();
+            timing_.lastByteAt = ESP.getCycleCount();
+        }
+    }
+
+    auto send() -> void
+    {
+        received_ = 0;
+
+        // drops any stale byte from a previous transaction.
+        while (transport_.available() > 0)
+        {
+            transport_.read();
+        }
+
+        timing_ = ModbusTiming{.sentAt = ESP.getCycleCount()};
+
+        transport_.transmit(request_.bytes, request_.size());
+
+        state_ = ModbusState::Transmitting;
+    }
+
+    auto complete(ModbusFault fault) -> void
+    {
+        if (fault == ModbusFault::None)
+        {
+            finish(ModbusState::Done);
+        }
+        else
+        {
+            reject(fault);
+        }
+    }
+
+    // Counts the fault, then retries the request or gives up.
+    auto reject(ModbusFault fault) -> void
+    {
+        switch (fault)
+        {
+        case ModbusFault::Timeout:
+            statistics_.timeouts++;
+            break;
+        case ModbusFault::Crc:
+            statistics_.crcFailures++;
+            break;
+        case ModbusFault::Exception:
+            statistics_.exceptions++;
+            break;
+        default:
+            statistics_.malformed++;
+            break;
+        }
+
+        if (attempts_ < retries_ && ModbusFaultIsTransient(fault, response_))
+        {
+            uint32_t backoff = static_cast<uint32_t>(MODBUS_RETRY_BACKOFF_MS) << attempts_;
+
+            backoff_ = backoff < MODBUS_RETRY_BACKOFF_MAX_MS ? backoff : MODBUS_RETRY_BACKOFF_MAX_MS;
+            attempts_++;
+            statistics_.retries++;
+
+            startedAt_ = millis();
+            state_ = ModbusState::Backoff;
+            return;
+        }
+
+        statistics_.failures++;
+        error_ = ModbusFaultError(fault, response_);
+        finish(ModbusState::Error);
+    }
+
+    auto finish(ModbusState state) -> void
+    {
+        state_ = state;
+
+        if (callback_ != nullptr)
+        {
+            callback_(*this);
+        }
+    }
+
+    Rs485Transport &transport_;
+    uint32_t silence_;
+
+    ModbusState state_ = ModbusState::Idle;
+    ModbusRequestFrame request_;
+    uint16_t count_ = 0;
+    uint8_t attempts_ = 0;
+    uint8_t retries_ = MODBUS_MAX_RETRIES;
+
+    uint8_t response_[MODBUS_MAX_RESPONSE_SIZE] = {};
+    size_t received_ = 0;
+
+    uint32_t startedAt_ = 0;
+    uint32_t backoff_ = 0;
+    uint32_t lastByteAt_ = 0;
+
+    Error error_ = Error::None;
+    Callback callback_ = nullptr;
+
+    ModbusStatistics statistics_;
+    ModbusTiming timing_;
+};
+
+#endif // ! _ModbusMaster_h_
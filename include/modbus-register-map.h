@@ -0,0 +1,142 @@
+/**
+ * @file modbus-register-map.h
+ * @brief Register map of the soil sensor.
+ * @details This file contains the table of holding registers exposed by the soil sensor and
+ * the planner that merges adjacent registers into as few reads as possible.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusRegisterMap_h_
+#define _ModbusRegisterMap_h_
+
+#include <config/modbus.h>
+
+#include <c_types.h>
+#include <stddef.h>
+
+/**
+ * @brief The parameters measured by the soil sensor
+ */
+enum class SoilParameter : uint8_t
+{
+    Temperature,
+    Water,
+    Ph,
+    Nitrogen,
+    Phosphorus,
+    Potassium,
+};
+
+/**
+ * @brief A holding register of the soil sensor
+ */
+struct ModbusRegister
+{
+    SoilParameter parameter;
+
+    // The type name of the measure, as registered on the broker.
+    const char *type;
+
+    uint16_t address;
+
+    // Number of decimal places of the raw value, e.g. 1 for 0.1 units.
+    uint8_t decimals;
+
+    bool isSigned;
+
+    // Change of the raw value, in either direction, that speeds up the sampling.
+    int32_t threshold;
+};
+
+/**
+ * @brief The registers read on every measure, sorted by address.
+ */
+constexpr ModbusRegister SOIL_REGISTERS[] = {
+    {SoilParameter::Temperature, "temperature", 0x0200, 1, true, 5},
+    {SoilParameter::Water, "water", 0x0201, 1, false, 20},
+    {SoilParameter::Ph, "ph", 0x0203, 1, false, 2},
+    {SoilParameter::Nitrogen, "nitrogen", 0x0204, 0, false, 5},
+    {SoilParameter::Phosphorus, "phosphorus", 0x0205, 0, false, 5},
+    {SoilParameter::Potassium, "potassium", 0x0206, 0, false, 5},
+};
+
+constexpr size_t SOIL_REGISTERS_LENGTH = sizeof(SOIL_REGISTERS) / sizeof(SOIL_REGISTERS[0]);
+
+/**
+ * @brief A span of registers fetched by a single function 0x03 read
+ */
+struct ModbusReadGroup
+{
+    uint16_t start = 0;
+    uint16_t count = 0;
+
+    // Index of the first register of the group on the register table.
+    uint8_t first = 0;
+
+    // Number of table entries covered by the group.
+    uint8_t length = 0;
+};
+
+/**
+ * @brief The read groups of a register table
+ */
+template <size_t N>
+struct ModbusReadPlan
+{
+    ModbusReadGroup groups[N] = {};
+    size_t length = 0;
+};
+
+/**
+ * @brief Merge the registers of the table into read groups.
+ * @details Registers closer than MODBUS_MAX_REGISTER_GAP are merged in the same group, as long
+ * as the group does not exceed MODBUS_MAX_REGISTERS_PER_READ registers.
+ *
+ * @param registers the register table, sorted by address
+ *
+ * @return ModbusReadPlan<N> the read groups
+ */
+template <size_t N>
+constexpr auto PlanModbusReads(const ModbusRegister (&registers)[N]) -> ModbusReadPlan<N>
+{
+    ModbusReadPlan<N> plan;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        auto address = registers[i].address;
+
+        if (plan.length > 0)
+        {
+            auto &group = plan.groups[plan.length - 1];
+            auto end = group.start + group.count;
+
+            if (address >= end &&
+                address - end <= MODBUS_MAX_REGISTER_GAP &&
+                address - group.start < MODBUS_MAX_REGISTERS_PER_READ)
+            {
+                group.count = address - group.start + 1;
+                group.length++;
+                continue;
+            }
+        }
+
+        plan.groups[plan.length++] = ModbusReadGroup{
+            .start = address,
+            .count = 1,
+            .first = static_cast<uint8_t>(i),
+            .length = 1,
+        };
+    }
+
+    return plan;
+}
+
+/**
+ * @brief The read groups of SOIL_REGISTERS, computed at compile time.
+ */
+constexpr auto SOIL_READ_PLAN = PlanModbusReads(SOIL_REGISTERS);
+
+#endif // ! _ModbusRegisterMap_h_
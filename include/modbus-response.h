@@ -0,0 +1,186 @@
+/**
+ * @file modbus-response.h
+ * @brief Modbus RTU response validation
+ * @details This file contains the checks applied to every response of a slave and the mapping
+ * of Modbus exception codes to Error values.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusResponse_h_
+#define _ModbusResponse_h_
+
+#include <ErrorOr.h>
+
+#include <modbus-frame.h>
+
+/**
+ * @brief The reasons a response is rejected
+ */
+enum class ModbusFault : uint8_t
+{
+    None,
+    // The slave did not answer in time.
+    Timeout,
+    // The response stopped before its expected length.
+    Incomplete,
+    Crc,
+    // The response came from another slave.
+    Address,
+    // The response does not answer the requested function.
+    Function,
+    // The byte count does not match the requested registers.
+    ByteCount,
+    // The slave answered with an exception code.
+    Exception,
+};
+
+/**
+ * @brief Checks a response against its request
+ *
+ * @param response the response frame, CRC included
+ * @param length the number of bytes of the response
+ * @param request the request answered
+ *
+ * @return ModbusFault ModbusFault::None if the response is valid.
+ */
+auto ModbusCheckResponse(const uint8_t *response, size_t length, const ModbusRequestFrame &request) -> ModbusFault
+{
+    if (length < 5)
+    {
+        return ModbusFault::Incomplete;
+    }
+
+    if (ModbusCrc16(response, length) != 0)
+    {
+        return ModbusFault::Crc;
+    }
+
+    if (response[0] != request.bytes[0])
+    {
+        return ModbusFault::Address;
+    }
+
+    if (response[1] == (request.bytes[1] | 0x80))
+    {
+        return ModbusFault::Exception;
+    }
+
+    if (response[1] != request.bytes[1])
+    {
+        return ModbusFault::Function;
+    }
+
+    size_t count = (request.bytes[4] << 8) | request.bytes[5];
+
+    if (response[2] != 2 * count || length != 5 + 2 * count)
+    {
+        return ModbusFault::ByteCount;
+    }
+
+    return ModbusFault::None;
+}
+
+/**
+ * @brief Maps a Modbus exception code to an error
+ *
+ * @param code the exception code
+ *
+ * @return Error the error
+ */
+auto ModbusExceptionError(uint8_t code) -> Error
+{
+    const char *message;
+
+    switch (code)
+    {
+    case 0x01:
+        message = "Illegal function";
+        break;
+    case 0x02:
+        message = "Illegal data address";
+        break;
+    case 0x03:
+        message = "Illegal data value";
+        break;
+    case 0x04:
+        message = "Slave device failure";
+        break;
+    case 0x05:
+        message = "Acknowledge";
+        break;
+    case 0x06:
+        message = "Slave device busy";
+        break;
+    case 0x08:
+        message = "Memory parity error";
+        break;
+    case 0x0A:
+        message = "Gateway path unavailable";
+        break;
+    case 0x0B:
+        message = "Gateway target device failed to respond";
+        break;
+    default:
+        message = "Unknown exception";
+        break;
+    }
+
+    return {.context = "ModbusException", .message = message};
+}
+
+/**
+ * @brief Maps a rejected response to an error
+ *
+ * @param fault the fault of the response
+ * @param response the response frame, read for the exception code
+ *
+ * @return Error the error
+ */
+auto ModbusFaultError(ModbusFault fault, const uint8_t *response) -> Error
+{
+    switch (fault)
+    {
+    case ModbusFault::Timeout:
+        return {.context = "ModbusResponse", .message = "Timeout waiting for the response"};
+    case ModbusFault::Incomplete:
+        return {.context = "ModbusResponse", .message = "Incomplete response"};
+    case ModbusFault::Crc:
+        return {.context = "ModbusResponse", .message = "CRC mismatch"};
+    case ModbusFault::Address:
+        return {.context = "ModbusResponse", .message = "Unexpected slave address"};
+    case ModbusFault::Function:
+        return {.context = "ModbusResponse", .message = "Unexpected function code"};
+    case ModbusFault::ByteCount:
+        return {.context = "ModbusResponse", .message = "Unexpected byte count"};
+    case ModbusFault::Exception:
+        return ModbusExceptionError(response[2]);
+    default:
+        return Error::None;
+    }
+}
+
+/**
+ * @brief Checks whether repeating the request may succeed
+ *
+ * @param fault the fault of the response
+ * @param response the response frame, read for the exception code
+ *
+ * @return bool false for exceptions the slave will raise again, e.g. an illegal address.
+ */
+auto ModbusFaultIsTransient(ModbusFault fault, const uint8_t *response) -> bool
+{
+    if (fault != ModbusFault::Exception)
+    {
+        return fault != ModbusFault::None;
+    }
+
+    auto code = response[2];
+
+    // acknowledge, busy and the gateway failures clear by themselves.
+    return code == 0x05 || code == 0x06 || code == 0x0A || code == 0x0B;
+}
+
+#endif // ! _ModbusResponse_h_
@@ -0,0 +1,105 @@
+/**
+ * @file modbus-slaves.h
+ * @brief Slaves of the RS485 bus
+ * @details This file contains the list of probes sharing the bus and the health kept for each
+ * of them. A slave that keeps failing is skipped for a growing number of rounds, so a dead
+ * probe costs one short probe from time to time instead of the full retry budget every round.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _ModbusSlaves_h_
+#define _ModbusSlaves_h_
+
+#include <config/modbus.h>
+
+#include <c_types.h>
+
+/**
+ * @brief Addresses of the probes on the bus, in polling order.
+ */
+constexpr uint8_t MODBUS_SLAVES[] = {MODBUS_SLAVE_ADDRESSES};
+
+constexpr size_t MODBUS_SLAVES_LENGTH = sizeof(MODBUS_SLAVES) / sizeof(MODBUS_SLAVES[0]);
+
+static_assert(MODBUS_SLAVE_DEAD_AFTER > 0, "MODBUS_SLAVE_DEAD_AFTER must be positive");
+
+/**
+ * @brief The health of a slave
+ */
+class ModbusSlaveHealth
+{
+public:
+    /**
+     * @brief Checks whether the slave is polled on this round
+     * @details Consumes one skipped round of a dead slave.
+     */
+    auto due() -> bool
+    {
+        if (skip_ == 0)
+        {
+            return true;
+        }
+
+        skip_--;
+        return false;
+    }
+
+    /**
+     * @brief Checks whether the slave is considered dead
+     */
+    auto dead() const -> bool { return consecutiveFailures_ >= MODBUS_SLAVE_DEAD_AFTER; }
+
+    auto succeed() -> void
+    {
+        readings_++;
+        consecutiveFailures_ = 0;
+        backoff_ = 0;
+    }
+
+    /**
+     * @brief Counts a failed reading, doubling the rounds skipped once the slave is dead
+     */
+    auto fail() -> void
+    {
+        failures_++;
+
+        if (consecutiveFailures_ < UINT8_MAX)
+        {
+            consecutiveFailures_++;
+        }
+
+        if (!dead())
+        {
+            return;
+        }
+
+        backoff_ = backoff_ == 0 ? 1 : backoff_ * 2;
+
+        if (backoff_ > MODBUS_SLAVE_BACKOFF_MAX_ROUNDS)
+        {
+            backoff_ = MODBUS_SLAVE_BACKOFF_MAX_ROUNDS;
+        }
+
+        skip_ = backoff_;
+    }
+
+    auto readings() const -> uint32_t { return readings_; }
+
+    auto failures() const -> uint32_t { return failures_; }
+
+    auto consecutiveFailures() const -> uint8_t { return consecutiveFailures_; }
+
+private:
+    uint32_t readings_ = 0;
+    uint32_t failures_ = 0;
+    uint8_t consecutiveFailures_ = 0;
+
+    // Rounds skipped after the next failure, and rounds left to skip.
+    uint16_t backoff_ = 0;
+    uint16_t skip_ = 0;
+};
+
+#endif // ! _ModbusSlaves_h_
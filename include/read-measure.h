@@ -11,55 +11,376 @@
 #ifndef _ReadMeasure_h_
 #define _ReadMeasure_h_
 
+#include <config/measure.h>
 #include <measure.h>
 #include <file.h>
-#include <SoftwareSerial.h>
+#include <modbus-master.h>
+#include <modbus-slaves.h>
+#include <measure-filter.h>
+#include <sampling-scheduler.h>
+#include <data-frame.h>
+#include <rs485-transport.h>
 
-#define RE 6
-#define DE 7
+/**
+ * @brief The RS485 bus of the sensor.
+ */
+Rs485Transport sensorBus;
+
+/**
+ * @brief Prepares the RS485 bus of the sensor
+ */
+auto BeginSensorBus() -> void
+{
+    sensorBus.begin(MODBUS_BAUD_RATE);
+}
+
+/**
+ * @brief The transaction of the sensor bus.
+ */
+ModbusTransaction sensorTransaction(sensorBus, MODBUS_BAUD_RATE);
+
+/**
+ * @brief The progress of a round over the slaves of the sensor bus
+ */
+struct MeasureReading
+{
+    bool active = false;
+
+    // Index of the slave of MODBUS_SLAVES being read.
+    size_t slave = 0;
+
+    // Number of readings of SOIL_READ_PLAN completed, up to MEASURE_OVERSAMPLING.
+    size_t sample = 0;
+
+    // Index of the group of SOIL_READ_PLAN being read.
+    size_t group = 0;
+
+    // Retries of each transaction of the slave being read, none for a dead one.
+    uint8_t retries = MODBUS_MAX_RETRIES;
+
+    // Measures of the slaves read on this round.
+    MeasureBatch measures;
+
+    // Number of slaves read on this round, and the failure of the last one that was not.
+    size_t read = 0;
+    Error error = Error::None;
+};
+
+MeasureReading measureReading;
+
+/**
+ * @brief The filter of each register of SOIL_REGISTERS, per slave of MODBUS_SLAVES.
+ */
+MeasureFilter measureFilters[MODBUS_SLAVES_LENGTH][SOIL_REGISTERS_LENGTH];
+
+/**
+ * @brief The health of each slave of MODBUS_SLAVES.
+ */
+ModbusSlaveHealth sensorSlaves[MODBUS_SLAVES_LENGTH];
+
+/**
+ * @brief Get the health of a slave
+ *
+ * @param slave the index of the slave on MODBUS_SLAVES
+ */
+auto GetSlaveHealth(size_t slave) -> const ModbusSlaveHealth &
+{
+    return sensorSlaves[slave];
+}
+
+/**
+ * @brief The scheduler of the readings.
+ */
+SamplingScheduler measureScheduler;
+
+/**
+ * @brief Get the current interval between two readings, in milliseconds
+ */
+auto GetMeasurePeriod() -> uint32_t
+{
+    return measureScheduler.period();
+}
+
+/**
+ * @brief The timing histograms of each group of SOIL_READ_PLAN.
+ */
+ModbusGroupDiagnostics measureDiagnostics[SOIL_READ_PLAN.length];
+
+/**
+ * @brief Get the timing histograms of a read group
+ *
+ * @param group the index of the group on SOIL_READ_PLAN
+ *
+ * @return const ModbusGroupDiagnostics& the histograms
+ */
+auto GetMeasureDiagnostics(size_t group) -> const ModbusGroupDiagnostics &
+{
+    return measureDiagnostics[group];
+}
+
+/**
+ * @brief Formats the counters and the timing histograms of the sensor bus
+ *
+ * @return String the diagnostics, one line per read group
+ */
+auto MeasureDiagnosticsToString() -> String
+{
+    auto &statistics = sensorTransaction.statistics();
+
+    String result = String("transactions=") + statistics.transactions +
+                    " crc=" + statistics.crcFailures +
+                    " timeouts=" + statistics.timeouts +
+                    " exceptions=" + statistics.exceptions +
+                    " malformed=" + statistics.malformed +
+                    " retries=" + statistics.retries +
+                    " failures=" + statistics.failures +
+                    " period=" + GetMeasurePeriod();
+
+    for (size_t i = 0; i < SOIL_READ_PLAN.length; i++)
+    {
+        result += String("\n0x") + String(SOIL_READ_PLAN.groups[i].start, HEX) + ": " + measureDiagnostics[i].toString();
+    }
+
+    for (size_t i = 0; i < MODBUS_SLAVES_LENGTH; i++)
+    {
+        auto &health = sensorSlaves[i];
+
+        result += String("\nslave ") + MODBUS_SLAVES[i] +
+                  ": readings=" + health.readings() +
+                  " failures=" + health.failures() +
+                  (health.dead() ? " dead" : "");
+    }
+
+    return result;
+}
+
+/**
+ * @brief Feeds the registers of a read group to the filters of a slave
+ *
+ * @param slave the index of the slave on MODBUS_SLAVES
+ * @param group the group read
+ * @param transaction the finished transaction
+ */
+auto DecodeReadGroup(size_t slave, const ModbusReadGroup &group, const ModbusTransaction &transaction) -> void
+{
+    for (uint8_t i = group.first; i < group.first + group.length; i++)
+    {
+        auto &reg = SOIL_REGISTERS[i];
+        auto value = transaction.value(reg.address - group.start);
+
+        measureFilters[slave][i].add(reg.isSigned ? static_cast<int16_t>(value) : value);
+    }
+}
+
+/**
+ * @brief Closes the filters of a slave into measures
+ *
+ * @param slave the index of the slave on MODBUS_SLAVES
+ * @param flags the MeasureFlag of every measure of the slave
+ * @param measures receives one measure per register of SOIL_REGISTERS
+ */
+auto TakeFilteredMeasures(size_t slave, uint8_t flags, MeasureBatch &measures) -> void
+{
+    int32_t values[SOIL_REGISTERS_LENGTH];
+    auto timestamp = MeasureTimestamp(flags);
 
-const byte TEMPERATURE[] = {0x01, 0x03, 0x02, 0x00, 0x00, 0x01, 0x85, 0xc0};
-const byte WATER[] = {0x01, 0x03, 0x02, 0x01, 0x00, 0x01, 0x44, 0x01};
-const byte PH[] = {0x01, 0x03, 0x02, 0x03, 0x00, 0x01, 0x04, 0x41};
-const byte NITROGEN[] = {0x01, 0x03, 0x02, 0x04, 0x00, 0x01, 0x45, 0x01};
-const byte PHOSPHORUS[] = {0x01, 0x03, 0x02, 0x05, 0x00, 0x01, 0x85, 0xc0};
-const byte POTASSIUM[] = {0x01, 0x03, 0x02, 0x06, 0x00, 0x01, 0x44, 0x01};
+    for (size_t i = 0; i < SOIL_REGISTERS_LENGTH; i++)
+    {
+        auto &filter = measureFilters[slave][i];
+        uint8_t first = filter.primed() ? MEASURE_FLAG_NONE : MEASURE_FLAG_FIRST;
 
-byte values[11];
+        values[i] = filter.take();
 
-SoftwareSerial mod(2, 3);
+        measures.add({
+            .timestamp = timestamp,
+            .value = values[i],
+            .parameter = SOIL_REGISTERS[i].parameter,
+            .flags = static_cast<uint8_t>(flags | first),
+            .type = static_cast<uint8_t>(i),
+            .slave = MODBUS_SLAVES[slave],
+        });
+    }
+
+    measureScheduler.observe(slave, values);
+}
 
-byte nitrogen()
+/**
+ * @brief Starts reading the next slave due on this round
+ * @details Starts from `measureReading.slave`. A dead slave that is due gets a single
+ * attempt per transaction, without retries, for the whole of its reading.
+ *
+ * @return bool false if no slave is left on this round.
+ */
+auto BeginSlaveReading() -> bool
 {
-    digitalWrite(DE, HIGH);
-    digitalWrite(RE, HIGH);
-    delay(10);
-    if (mod.write(NITROGEN, sizeof(NITROGEN)) == 8)
+    auto &group = SOIL_READ_PLAN.groups[0];
+
+    for (; measureReading.slave < MODBUS_SLAVES_LENGTH; measureReading.slave++)
     {
-        digitalWrite(DE, LOW);
-        digitalWrite(RE, LOW);
-        for (byte i = 0; i < 7; i++)
+        auto &health = sensorSlaves[measureReading.slave];
+
+        if (!health.due())
         {
-            // Serial.print(mod.read(),HEX);
-            values[i] = mod.read();
-            Serial.print(values[i], HEX);
+            continue;
         }
-        Serial.println();
+
+        measureReading.retries = health.dead() ? 0 : MODBUS_MAX_RETRIES;
+
+        if (sensorTransaction.begin(MODBUS_SLAVES[measureReading.slave], group.start, group.count, measureReading.retries))
+        {
+            measureReading.sample = 0;
+            measureReading.group = 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Starts a reading of the sensors
+ * @details The slaves of MODBUS_SLAVES are read in turn, skipping the dead ones that are
+ * backing off. Every group of adjacent registers of SOIL_REGISTERS is fetched in a single
+ * transaction, so a full reading costs one round trip per group instead of one per parameter.
+ * The registers are read MEASURE_OVERSAMPLING times and filtered into a single measure.
+ * The reading is advanced by PollMeasureFromSensor().
+ *
+ * @return bool false if a reading is already in progress, or no slave is due.
+ */
+auto RequestMeasureFromSensor() -> bool
+{
+    if (measureReading.active)
+    {
+        return false;
     }
-    return values[4];
+
+    measureReading = MeasureReading();
+    measureScheduler.start(millis());
+
+    measureReading.active = BeginSlaveReading();
+
+    return measureReading.active;
+}
+
+/**
+ * @brief Starts a reading of the sensor when the scheduler says it is due
+ *
+ * @return bool true if a reading started.
+ */
+auto ScheduleMeasureFromSensor() -> bool
+{
+    return measureScheduler.due(millis()) && RequestMeasureFromSensor();
+}
+
+/**
+ * @brief Advances the reading of the sensor without blocking
+ *
+ * @param result receives the list of measures, or the failure, when the reading ends
+ *
+ * @return bool true when the round over the slaves ended and `result` was set.
+ */
+auto PollMeasureFromSensor(ErrorOr<MeasureBatch> &result) -> bool
+{
+    if (!measureReading.active)
+    {
+        return false;
+    }
+
+    auto state = sensorTransaction.poll();
+    auto slave = measureReading.slave;
+
+    if (state == ModbusState::Error)
+    {
+        // drops the partial readings, the next measure of the slave starts over.
+        for (auto &filter : measureFilters[slave])
+        {
+            filter.discard();
+        }
+
+        sensorSlaves[slave].fail();
+        measureReading.error = sensorTransaction.error();
+
+        LOG_WARN(MEASURE) << "Slave " << int(MODBUS_SLAVES[slave]) << ": " << measureReading.error;
+    }
+    else if (state == ModbusState::Done)
+    {
+        DecodeReadGroup(slave, SOIL_READ_PLAN.groups[measureReading.group], sensorTransaction);
+
+        auto timing = sensorTransaction.timing();
+        timing.decodedAt = ESP.getCycleCount();
+        measureDiagnostics[measureReading.group].add(timing);
+
+        if (++measureReading.group == SOIL_READ_PLAN.length)
+        {
+            measureReading.group = 0;
+            measureReading.sample++;
+        }
+
+        if (measureReading.sample < MEASURE_OVERSAMPLING)
+        {
+            auto &group = SOIL_READ_PLAN.groups[measureReading.group];
+            sensorTransaction.begin(MODBUS_SLAVES[slave], group.start, group.count, measureReading.retries);
+            return false;
+        }
+
+        auto flags = sensorSlaves[slave].dead() ? MEASURE_FLAG_RECOVERED : MEASURE_FLAG_NONE;
+
+        TakeFilteredMeasures(slave, flags, measureReading.measures);
+        sensorSlaves[slave].succeed();
+        measureReading.read++;
+    }
+    else
+    {
+        return false;
+    }
+
+    measureReading.slave++;
+
+    if (BeginSlaveReading())
+    {
+        return false;
+    }
+
+    measureReading.active = false;
+    measureScheduler.adapt();
+
+    if (measureReading.read == 0)
+    {
+        result = failure(measureReading.error);
+    }
+    else
+    {
+        result = ok(measureReading.measures);
+    }
+
+    return true;
 }
 
 /**
  * @brief Read the measure from the sensor
+ * @details Blocks until the reading ends. Prefer RequestMeasureFromSensor() and
+ * PollMeasureFromSensor() from loop().
  *
- * @return ErrorOr<LL<Measure>> list of measures.
+ * @return ErrorOr<MeasureBatch> the measures of the slaves read, or the last failure if none was.
  */
-auto ReadMeasureFromSensor() -> ErrorOr<LL<Measure>>
+auto ReadMeasureFromSensor() -> ErrorOr<MeasureBatch>
 {
-    // TODO: get REAL mesuares.
-    auto measures = LL<Measure>();
+    ErrorOr<MeasureBatch> result;
+
+    if (!RequestMeasureFromSensor())
+    {
+        return failure({
+            .context = "ReadMeasureFromSensor",
+            .message = "A reading is already in progress or no slave is due",
+        });
+    }
+
+    while (!PollMeasureFromSensor(result))
+    {
+        yield();
+    }
 
-    return ok(measures);
+    return result;
 }
 
-#endif // ! _ReadMeasure_h_
\ No newline at end of file
+#endif // ! _ReadMeasure_h_
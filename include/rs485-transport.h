@@ -0,0 +1,188 @@
+/**
+ * @file rs485-transport.h
+ * @brief RS485 transport of the sensor bus.
+ * @details This file contains the RS485 transports of the sensor bus. The transport is chosen
+ * at compile time by RS485_TRANSPORT and switches the DE/RE pins by itself, releasing the
+ * driver once the last byte has left the wire.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _Rs485Transport_h_
+#define _Rs485Transport_h_
+
+#include <Arduino.h>
+
+#include <config/modbus.h>
+
+/**
+ * @brief Drives the direction pins of the RS485 transceiver
+ */
+class Rs485Transceiver
+{
+protected:
+    auto beginDriver() -> void
+    {
+        pinMode(RS485_RE_PIN, OUTPUT);
+        pinMode(RS485_DE_PIN, OUTPUT);
+
+        enableDriver(false);
+    }
+
+    // The driver and the receiver enable pins share the level: high to talk, low to listen.
+    auto enableDriver(bool enable) -> void
+    {
+        digitalWrite(RS485_DE_PIN, enable ? HIGH : LOW);
+        digitalWrite(RS485_RE_PIN, enable ? HIGH : LOW);
+    }
+};
+
+#if RS485_TRANSPORT == RS485_TRANSPORT_SOFTWARE_SERIAL
+
+#include <SoftwareSerial.h>
+
+/**
+ * @brief RS485 transport over a bit-banged serial on RS485_RX_PIN and RS485_TX_PIN
+ */
+class SoftwareSerialTransport : public Rs485Transceiver
+{
+public:
+    SoftwareSerialTransport()
+        : serial_(RS485_RX_PIN, RS485_TX_PIN) {}
+
+    auto begin(uint32_t baudRate) -> void
+    {
+        beginDriver();
+        serial_.begin(baudRate);
+    }
+
+    /**
+     * @brief Enables the driver and sends the buffer
+     */
+    auto transmit(const uint8_t *buffer, size_t length) -> void
+    {
+        enableDriver(true);
+        serial_.write(buffer, length);
+    }
+
+    /**
+     * @brief Checks whether the last transmission left the wire, releasing the driver if so
+     */
+    auto transmitted() -> bool
+    {
+        // bit-banged writes return only after the stop bit of the last byte.
+        enableDriver(false);
+        return true;
+    }
+
+    auto available() -> int { return serial_.available(); }
+
+    auto read() -> int { return serial_.read(); }
+
+private:
+    SoftwareSerial serial_;
+};
+
+typedef SoftwareSerialTransport Rs485Transport;
+
+#elif RS485_TRANSPORT == RS485_TRANSPORT_UART0
+
+#include <HardwareSerial.h>
+#include <Internal.h>
+
+#ifndef UART_TX_FIFO_SIZE
+#define UART_TX_FIFO_SIZE 0x80
+#endif // ! UART_TX_FIFO_SIZE
+
+#ifdef DEBUG_SERIAL_IS_UART0
+#error "The UART0 transport takes over Serial. Build with -D DEBUG_SERIAL=Serial1 to keep the debug output."
+#endif // ! DEBUG_SERIAL_IS_UART0
+
+/**
+ * @brief RS485 transport over UART0, swapped to GPIO13 (RX) and GPIO15 (TX)
+ * @details UART1 can only transmit on the ESP8266, so UART0 is the only hardware UART able
+ * to hold the bus.
+ */
+class HardwareSerialTransport : public Rs485Transceiver
+{
+public:
+    HardwareSerialTransport()
+        : serial_(Serial) {}
+
+    auto begin(uint32_t baudRate) -> void
+    {
+        beginDriver();
+
+        serial_.begin(baudRate, SERIAL_8N1);
+        serial_.swap();
+
+        characterMicros_ = 11000000UL / baudRate;
+    }
+
+    /**
+     * @brief Enables the driver and queues the buffer on the TX FIFO
+     */
+    auto transmit(const uint8_t *buffer, size_t length) -> void
+    {
+        enableDriver(true);
+        serial_.write(buffer, length);
+
+        transmitting_ = true;
+        drained_ = false;
+    }
+
+    /**
+     * @brief Checks whether the last transmission left the wire, releasing the driver if so
+     */
+    auto transmitted() -> bool
+    {
+        if (!transmitting_)
+        {
+            return true;
+        }
+
+        if (!drained_)
+        {
+            if (serial_.availableForWrite() < UART_TX_FIFO_SIZE)
+            {
+                return false;
+            }
+
+            // the FIFO is empty, the last byte is still in the shift register.
+            drained_ = true;
+            drainedAt_ = micros();
+        }
+
+        if (micros() - drainedAt_ < characterMicros_)
+        {
+            return false;
+        }
+
+        enableDriver(false);
+        transmitting_ = false;
+
+        return true;
+    }
+
+    auto available() -> int { return serial_.available(); }
+
+    auto read() -> int { return serial_.read(); }
+
+private:
+    HardwareSerial &serial_;
+
+    uint32_t characterMicros_ = 0;
+    uint32_t drainedAt_ = 0;
+    bool transmitting_ = false;
+    bool drained_ = false;
+};
+
+typedef HardwareSerialTransport Rs485Transport;
+
+#else
+#error "RS485_TRANSPORT must be RS485_TRANSPORT_SOFTWARE_SERIAL or RS485_TRANSPORT_UART0"
+#endif // ! RS485_TRANSPORT
+
+#endif // ! _Rs485Transport_h_
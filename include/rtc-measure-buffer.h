@@ -0,0 +1,260 @@
+/**
+ * @file rtc-measure-buffer.h
+ * @brief Buffer of measures in RTC memory
+ * @details This file contains the buffer that batches measures in the RTC user memory, which
+ * survives deep sleep. Measures only reach the measure log once the buffer is full or its
+ * oldest measure waited MEASURE_RTC_FLUSH_S, so the flash is written once per batch instead
+ * of once per reading.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _RtcMeasureBuffer_h_
+#define _RtcMeasureBuffer_h_
+
+#include <config/measure.h>
+#include <measure.h>
+#include <measure-log.h>
+
+#include <Crc32.h>
+
+/**
+ * @brief Marks RTC memory written by the measure buffer.
+ */
+#define MEASURE_RTC_MAGIC 0x4D525442
+
+/**
+ * @brief The header of the buffer
+ */
+struct RtcMeasureHeader
+{
+    uint32_t magic;
+
+    // CRC-32 of the fields below and of the `count` first records.
+    uint32_t crc;
+
+    uint16_t count;
+    uint16_t reserved;
+
+    // Seconds the oldest record waited, counted while awake.
+    uint32_t age;
+};
+
+/**
+ * @brief Number of records that fit on the buffer.
+ */
+constexpr size_t MEASURE_RTC_CAPACITY = (MEASURE_RTC_SIZE - sizeof(RtcMeasureHeader)) / sizeof(Measure);
+
+static_assert(MEASURE_RTC_SIZE % 4 == 0, "MEASURE_RTC_SIZE must be a multiple of 4 bytes");
+static_assert(MEASURE_RTC_OFFSET >= 32, "The first 128 bytes of the RTC user memory belong to eboot");
+static_assert(MEASURE_RTC_OFFSET * 4 + MEASURE_RTC_SIZE <= 512, "The measure buffer must fit on the RTC user memory");
+static_assert(MEASURE_RTC_CAPACITY >= MEASURE_BATCH_CAPACITY, "The measure buffer must hold a full batch");
+
+/**
+ * @brief The buffer of measures in RTC memory
+ */
+class RtcMeasureBuffer
+{
+public:
+    /**
+     * @brief Loads the buffer left by the previous boot
+     * @details Starts empty when the memory was never written or its CRC fails, e.g. after
+     * a power loss.
+     */
+    auto restore() -> void
+    {
+        ESP.rtcUserMemoryRead(MEASURE_RTC_OFFSET, reinterpret_cast<uint32_t *>(&data_), sizeof(data_));
+
+        if (data_.header.magic != MEASURE_RTC_MAGIC ||
+            data_.header.count > MEASURE_RTC_CAPACITY ||
+            data_.header.crc != checksum())
+        {
+            data_.header = RtcMeasureHeader{.magic = MEASURE_RTC_MAGIC};
+        }
+
+        seen_ = uptime();
+    }
+
+    /**
+     * @brief Appends a batch
+     *
+     * @return bool false if the batch does not fit.
+     */
+    auto add(const MeasureBatch &measures) -> bool
+    {
+        if (data_.header.count + measures.length() > MEASURE_RTC_CAPACITY)
+        {
+            return false;
+        }
+
+        if (data_.header.count == 0)
+        {
+            data_.header.age = 0;
+            seen_ = uptime();
+        }
+
+        for (auto &measure : measures)
+        {
+            data_.records[data_.header.count++] = measure;
+        }
+
+        save();
+
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the buffer must be flushed
+     *
+     * @return bool true if another batch would not fit, or the oldest record waited too long.
+     */
+    auto due() -> bool
+    {
+        if (data_.header.count == 0)
+        {
+            return false;
+        }
+
+        return data_.header.count + MEASURE_BATCH_CAPACITY > MEASURE_RTC_CAPACITY ||
+               age() >= MEASURE_RTC_FLUSH_S;
+    }
+
+    /**
+     * @brief Seconds the oldest record waited
+     * @details Deep sleep is only accounted for once the clock is synced.
+     */
+    auto age() -> uint32_t
+    {
+        uint8_t flags = MEASURE_FLAG_NONE;
+        auto now = MeasureTimestamp(flags);
+        auto &oldest = data_.records[0];
+
+        if (!(flags & MEASURE_FLAG_UPTIME) && !(oldest.flags & MEASURE_FLAG_UPTIME) && now >= oldest.timestamp)
+        {
+            return now - oldest.timestamp;
+        }
+
+        return data_.header.age + (uptime() - seen_);
+    }
+
+    auto records() const -> const Measure * { return data_.records; }
+
+    auto length() const -> size_t { return data_.header.count; }
+
+    auto clear() -> void
+    {
+        data_.header.count = 0;
+        data_.header.age = 0;
+        save();
+    }
+
+private:
+    static auto uptime() -> uint32_t { return millis() / 1000; }
+
+    auto checksum() const -> uint32_t
+    {
+        auto crc = utility::crc32(&data_.header.count, sizeof(RtcMeasureHeader) - offsetof(RtcMeasureHeader, count));
+
+        return utility::crc32(data_.records, data_.header.count * sizeof(Measure), crc);
+    }
+
+    auto save() -> void
+    {
+        auto now = uptime();
+
+        data_.header.age += now - seen_;
+        seen_ = now;
+        data_.header.crc = checksum();
+
+        // only the used part of the memory is written.
+        size_t size = sizeof(RtcMeasureHeader) + data_.header.count * sizeof(Measure);
+
+        ESP.rtcUserMemoryWrite(MEASURE_RTC_OFFSET, reinterpret_cast<uint32_t *>(&data_), (size + 3) & ~3);
+    }
+
+    struct
+    {
+        RtcMeasureHeader header;
+        Measure records[MEASURE_RTC_CAPACITY];
+    } data_ __attribute__((aligned(4)));
+
+    // Uptime, in seconds, up to which `age` is accounted.
+    uint32_t seen_ = 0;
+};
+
+/**
+ * @brief The buffer of the measures of the node.
+ */
+RtcMeasureBuffer rtcMeasureBuffer;
+
+/**
+ * @brief Moves the buffered measures to the measure log
+ *
+ * @return ErrorOr<> can be ok() or failure(). The buffer is kept on failure.
+ */
+auto FlushMeasureBuffer() -> ErrorOr<>
+{
+    if (rtcMeasureBuffer.length() == 0)
+    {
+        return ok();
+    }
+
+    auto result = SaveMeasureOnFile(rtcMeasureBuffer.records(), rtcMeasureBuffer.length());
+
+    if (result.ok())
+    {
+        rtcMeasureBuffer.clear();
+    }
+
+    return result;
+}
+
+/**
+ * @brief Restores the buffer of the previous boot, flushing it if it is due
+ * @details Must run once the measure log is open.
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto RestoreMeasureBuffer() -> ErrorOr<>
+{
+    rtcMeasureBuffer.restore();
+
+    if (rtcMeasureBuffer.due())
+    {
+        return FlushMeasureBuffer();
+    }
+
+    return ok();
+}
+
+/**
+ * @brief Buffers a batch of measures, flushing the buffer when it is full or past its deadline
+ *
+ * @param measures the measures to buffer
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto BufferMeasure(const MeasureBatch &measures) -> ErrorOr<>
+{
+    if (!rtcMeasureBuffer.add(measures))
+    {
+        auto result = FlushMeasureBuffer();
+
+        // keeps the batch out of RTC memory rather than losing it.
+        if (!result.ok() || !rtcMeasureBuffer.add(measures))
+        {
+            return SaveMeasureOnFile(measures);
+        }
+    }
+
+    if (rtcMeasureBuffer.due())
+    {
+        return FlushMeasureBuffer();
+    }
+
+    return ok();
+}
+
+#endif // ! _RtcMeasureBuffer_h_
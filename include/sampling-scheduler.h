@@ -0,0 +1,124 @@
+/**
+ * @file sampling-scheduler.h
+ * @brief Adaptive scheduler of the sensor readings.
+ * @details This file contains the scheduler that decides when the sensor is read. The period
+ * drops to MEASURE_MIN_INTERVAL_MS as soon as a parameter moves by more than its threshold,
+ * and grows geometrically up to MEASURE_MAX_INTERVAL_MS while the soil stays flat.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _SamplingScheduler_h_
+#define _SamplingScheduler_h_
+
+#include <config/measure.h>
+#include <modbus-register-map.h>
+#include <modbus-slaves.h>
+
+static_assert(MEASURE_MIN_INTERVAL_MS <= MEASURE_INTERVAL_MS &&
+                  MEASURE_INTERVAL_MS <= MEASURE_MAX_INTERVAL_MS,
+              "MEASURE_INTERVAL_MS must be between MEASURE_MIN_INTERVAL_MS and MEASURE_MAX_INTERVAL_MS");
+static_assert(MEASURE_BACKOFF_PERCENT > 100, "MEASURE_BACKOFF_PERCENT must grow the period");
+
+/**
+ * @brief Schedules the readings of SOIL_REGISTERS on every slave
+ *
+ * For example:
+ *   scheduler.observe(slave, values); // for each slave read on the round
+ *   scheduler.adapt();
+ */
+class SamplingScheduler
+{
+public:
+    /**
+     * @brief Checks whether a reading is due
+     *
+     * @param now the current time, in milliseconds
+     */
+    auto due(uint32_t now) const -> bool
+    {
+        return !started_ || now - startedAt_ >= period_;
+    }
+
+    /**
+     * @brief Marks the start of a reading
+     *
+     * @param now the current time, in milliseconds
+     */
+    auto start(uint32_t now) -> void
+    {
+        started_ = true;
+        startedAt_ = now;
+    }
+
+    /**
+     * @brief Compares a new measure of a slave with its previous one
+     *
+     * @param slave the index of the slave on MODBUS_SLAVES
+     * @param values the raw value of each register of SOIL_REGISTERS
+     */
+    auto observe(size_t slave, const int32_t (&values)[SOIL_REGISTERS_LENGTH]) -> void
+    {
+        auto &last = last_[slave];
+
+        for (size_t i = 0; i < SOIL_REGISTERS_LENGTH; i++)
+        {
+            auto delta = values[i] - last[i];
+
+            if (primed_[slave] && (delta > SOIL_REGISTERS[i].threshold || -delta > SOIL_REGISTERS[i].threshold))
+            {
+                changed_ = true;
+            }
+
+            last[i] = values[i];
+        }
+
+        if (primed_[slave])
+        {
+            compared_ = true;
+        }
+
+        primed_[slave] = true;
+    }
+
+    /**
+     * @brief Adapts the period to the measures observed since the last call
+     * @details Any slave moving past a threshold drops the period to the minimum. The period
+     * only grows when at least one slave was compared and none of them moved.
+     */
+    auto adapt() -> void
+    {
+        if (changed_)
+        {
+            period_ = MEASURE_MIN_INTERVAL_MS;
+        }
+        else if (compared_)
+        {
+            uint32_t period = static_cast<uint64_t>(period_) * MEASURE_BACKOFF_PERCENT / 100;
+            period_ = period < MEASURE_MAX_INTERVAL_MS ? period : MEASURE_MAX_INTERVAL_MS;
+        }
+
+        changed_ = false;
+        compared_ = false;
+    }
+
+    /**
+     * @brief Get the current period, in milliseconds
+     */
+    auto period() const -> uint32_t { return period_; }
+
+private:
+    uint32_t period_ = MEASURE_INTERVAL_MS;
+    uint32_t startedAt_ = 0;
+    bool started_ = false;
+
+    int32_t last_[MODBUS_SLAVES_LENGTH][SOIL_REGISTERS_LENGTH] = {};
+    bool primed_[MODBUS_SLAVES_LENGTH] = {};
+
+    bool changed_ = false;
+    bool compared_ = false;
+};
+
+#endif // ! _SamplingScheduler_h_
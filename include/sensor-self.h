@@ -11,140 +11,95 @@
 #ifndef _SensorSelf_h
 #define _SensorSelf_h
 
-#include <config/file-system.h>
-#include <file.h>
+#include <device-config.h>
 
-#include <StringHelper.h>
+#include <Arena.h>
+#include <StringView.h>
 
-auto SelfFromBrokerPayload(String &payload) -> ErrorOr<String>
+/**
+ * @brief Parses the sensor id from a payload of the broker, e.g. "success=true;id=<id>"
+ * @details The payload is parsed in place, only the id is copied out, on the arena.
+ *
+ * @param payload the payload, not null terminated
+ * @param length the length of the payload
+ * @param arena the arena of the message, holding the id
+ *
+ * @return ErrorOr<const char *> can be the id, empty if the payload carries none, or failure()
+ */
+auto SelfFromBrokerPayload(const char *payload, size_t length, utility::Arena &arena) -> ErrorOr<const char *>
 {
-    INTERNAL_DEBUG() << "Parsing the payload: " << payload;
+    LOG_TRACE(BROKER) << "Parsing the payload of " << length << " bytes...";
 
-    ErrorOr<String> result;
+    utility::Tokenizer tokens(utility::StringView(payload, length), ';');
+    utility::StringView token, key, value;
 
-    if (payload.length() == 0)
+    if (!tokens.next(token) || !token.splitPair('=', key, value) || value != "true" || !tokens.next(token))
     {
-        result = failure({.context = "GetSensorSelfFromBrokerPayload",
-                          .message = "Empty payload"});
+        return failure({
+            .context = "SelfFromBrokerPayload",
+            .message = "The payload is not valid",
+        });
     }
-    else
+
+    if (!token.splitPair('=', key, value))
     {
-        auto result1 = utility::StringHelper::splitStringToArray(payload, ';');
-
-        if (!result1.ok())
-        {
-            result = failure(result1.error());
-        }
-        else
-        {
-            INTERNAL_DEBUG() << "Splitting the payload...";
-            auto array = result1.unwrap();
-
-            auto successResult = utility::StringHelper::splitStringToArray(*array.at(0), '=');
-
-            if (!successResult.ok())
-            {
-                result = failure(successResult.error());
-            }
-            else
-            {
-                auto array2 = successResult.unwrap();
-
-                if (!array2.at(1)->equals("true"))
-                {
-                    result = failure({
-                        .context = "GetSensorSelfFromBrokerPayload",
-                        .message = "The payload is not valid",
-                    });
-                }
-                else
-                {
-                    INTERNAL_DEBUG() << "Parsing the payload...";
-
-                    auto result2 = utility::StringHelper::splitStringToArray(*array.at(1), '=');
-
-                    if (!result2.ok())
-                    {
-                        result = failure(result2.error());
-                    }
-                    else
-                    {
-                        auto id = *result2.unwrap().at(1);
-
-                        INTERNAL_DEBUG() << "Sensor id: " << id;
-
-                        result = ok(id);
-                    }
-                }
-            }
-        }
+        value = utility::StringView();
     }
 
-    return result;
+    const char *id = arena.copy(value.data(), value.length());
+
+    if (id == nullptr)
+    {
+        return failure({
+            .context = "SelfFromBrokerPayload",
+            .message = "The message arena is full",
+        });
+    }
+
+    LOG_DEBUG(BROKER) << "Sensor id: " << id;
+
+    return ok(id);
 }
 
 /**
- * @brief Get the sensor id from the file system.
+ * @brief Save the sensor id on the device configuration.
  *
  * @param id The sensor id.
  *
- * @return ErrorOr<String> The sensor id.
+ * @return ErrorOr<> can be ok() or failure()
  */
-auto SaveSelf(String &id) -> ErrorOr<>
+auto SaveSelf(const char *id) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Saving the sensor id...";
+    LOG_DEBUG(BROKER) << "Saving the sensor id...";
 
-    ErrorOr<> result;
-
-    auto file = OpenFile(SELF_FILE, "w");
-
-    if (!file.ok())
-    {
-        result = file.error();
-    }
-    else
-    {
-        auto file1 = file.unwrap();
-
-        file1.println(id);
-
-        file1.close();
-
-        result = ok();
-    }
+    return deviceConfig.update([&](DeviceConfig &config) -> bool
+                               { return SetDeviceConfigField(config.self, id, strlen(id)); },
+                               "SaveSelf");
+}
 
-    return result;
+/**
+ * @brief Checks if the sensor id was saved.
+ */
+auto HasSelf() -> bool
+{
+    return deviceConfig.get().self[0] != '\0';
 }
 
 auto LoadSelf() -> ErrorOr<String>
 {
-    INTERNAL_DEBUG() << "Loading the sensor id...";
-    ErrorOr<String> result;
+    LOG_DEBUG(BROKER) << "Loading the sensor id...";
+
+    auto &config = deviceConfig.get();
 
-    if (IsEmptyFile(SELF_FILE))
+    if (config.self[0] == '\0')
     {
-        result = failure({
+        return failure({
             .context = "LoadSelf",
-            .message = "The sensor id file is empty",
+            .message = "The sensor id is empty",
         });
     }
-    else
-    {
-        auto readResult = ReadFromFile(SELF_FILE, '\n');
-
-        if (!readResult.ok())
-        {
-            result = readResult.error();
-        }
-        else
-        {
-            auto lines = readResult.unwrap();
-            auto id = lines.at(0)->substring(0, lines.at(0)->length() - 1);
-
-            result = ok(id);
-        }
-    }
-    return result;
+
+    return ok(String(config.self));
 }
 
-#endif // ! _SensorSelf_h
\ No newline at end of file
+#endif // ! _SensorSelf_h
@@ -10,10 +10,12 @@
 #ifndef _SensorCredentials_h_
 #define _SensorCredentials_h_
 
-#include <file.h>
-#include <config/file-system.h>
+#include <device-config.h>
+#include <config/modbus.h>
 
-#include <StringHelper.h>
+#include <Arena.h>
+#include <StaticVector.h>
+#include <StringView.h>
 
 /**
  * @brief The credential of a sensor
@@ -22,226 +24,223 @@ struct SensorType
 {
     String type = "";
     String id = "";
+
+    // Address of the probe on the RS485 bus.
+    uint8_t slave = MODBUS_SLAVE_ADDRESS;
 };
 
 /**
- * @brief The group of credentials of a sensor
+ * @brief The group of credentials of a sensor, as many as the device configuration keeps
  */
-using SensorCredentials = LL<struct SensorType>;
+using SensorCredentials = utility::StaticVector<SensorType, DEVICE_CONFIG_TYPES_CAPACITY>;
 
-auto CredentialsFromBrokerPayload(String &payload) -> ErrorOr<SensorCredentials>
+/**
+ * @brief A credential of a payload of the broker, its texts on the arena of the message
+ */
+struct BrokerCredential
 {
-    INTERNAL_DEBUG() << "Parsing the payload: " << payload;
+    // Key of the type, as formatted by SensorTypeKey(), e.g. "ph" or "2:ph".
+    const char *key;
+
+    const char *id;
+};
 
-    ErrorOr<SensorCredentials> result;
+/**
+ * @brief The credentials of a payload of the broker
+ */
+using BrokerCredentials = utility::StaticVector<BrokerCredential, DEVICE_CONFIG_TYPES_CAPACITY>;
 
-    if (payload.length() == 0)
+/**
+ * @brief Formats the key of a type of a probe
+ *
+ * @param slave the address of the probe
+ * @param type the measured type
+ *
+ * @return String the type alone for the primary probe, e.g. "ph", or "<slave>:<type>", e.g. "2:ph".
+ */
+auto SensorTypeKey(uint8_t slave, const String &type) -> String
+{
+    if (slave == MODBUS_SLAVE_ADDRESS)
     {
-        result = failure({.context = "CredentialsFromBrokerPayload",
-                          .message = "Empty payload"});
+        return type;
+    }
+
+    return String(slave) + ":" + type;
+}
+
+/**
+ * @brief Parses a key formatted by SensorTypeKey()
+ *
+ * @param key the key
+ * @param credential receives the slave and the type
+ */
+auto ParseSensorTypeKey(utility::StringView key, SensorType &credential) -> void
+{
+    utility::StringView slave, type;
+
+    if (!key.splitPair(':', slave, type))
+    {
+        credential.slave = MODBUS_SLAVE_ADDRESS;
+        credential.type = key.toString();
     }
     else
     {
-        auto result1 = utility::StringHelper::splitStringToArray(payload, ';');
+        uint32_t address = 0;
 
-        if (!result1.ok())
-        {
-            result = failure(result1.error());
-        }
-        else
+        slave.toUInt(address);
+
+        credential.slave = address;
+        credential.type = type.toString();
+    }
+}
+
+/**
+ * @brief Finds the credential of a type of a probe
+ *
+ * @param credentials the credentials
+ * @param slave the address of the probe
+ * @param type the measured type
+ *
+ * @return const SensorType* the credential, or nullptr if the type of the probe is not registered.
+ */
+auto FindSensorCredential(const SensorCredentials &credentials, uint8_t slave, const String &type) -> const SensorType *
+{
+    for (auto &credential : credentials)
+    {
+        if (credential.slave == slave && credential.type == type)
         {
-            INTERNAL_DEBUG() << "Splitting the payload...";
-            auto array = result1.unwrap();
-
-            auto successResult = utility::StringHelper::splitStringToArray(*array.at(0), '=');
-
-            if (!successResult.ok())
-            {
-                result = failure(successResult.error());
-            }
-            else
-            {
-                auto success = successResult.unwrap().at(1);
-
-                INTERNAL_DEBUG() << "Success: " << *success << " (" << success->equals("true") << ")";
-
-                if (!success->equals("true"))
-                {
-                    result = failure({
-                        .context = "CredentialsFromBrokerPayload",
-                        .message = "The payload is not valid",
-                    });
-                }
-                else
-                {
-                    INTERNAL_DEBUG() << "Is a success. Parsing credentials...";
-
-                    SensorCredentials credentials;
-                    bool fail = false;
-
-                    for (int i = 1; i < array.length(); i++)
-                    {
-                        auto result2 = utility::StringHelper::splitStringToArray(*array.at(i), '=');
-                        INTERNAL_DEBUG() << "Value: " << *array.at(i) << " (" << result2.ok() << ")";
-
-                        if (result2.ok())
-                        {
-                            auto array2 = result2.unwrap();
-
-                            if (array2.length() == 0)
-                            {
-                                continue;
-                            }
-
-                            auto type = array2.at(0);
-                            auto id = array2.at(1);
-
-                            INTERNAL_DEBUG() << "Adding credential: " << *type << " - " << *id;
-
-                            credentials.add({.type = *type, .id = *id});
-                        }
-
-                        if (!fail)
-                        {
-                            result = ok(credentials);
-                        }
-                    }
-                }
-            }
+            return &credential;
         }
     }
 
-    return result;
+    return nullptr;
 }
 
-auto GetSensorCredentials() -> ErrorOr<SensorCredentials>
+/**
+ * @brief Parses the credentials from a payload of the broker, e.g. "success=true;ph=<id>;2:ph=<id>"
+ * @details The payload is parsed in place, only the keys and the ids are copied out, on the
+ * arena.
+ *
+ * @param payload the payload, not null terminated
+ * @param length the length of the payload
+ * @param arena the arena of the message, holding the keys and the ids
+ *
+ * @return ErrorOr<BrokerCredentials> can be the credentials or failure()
+ */
+auto CredentialsFromBrokerPayload(const char *payload, size_t length, utility::Arena &arena) -> ErrorOr<BrokerCredentials>
 {
-    auto result = ErrorOr<SensorCredentials>();
+    LOG_TRACE(BROKER) << "Parsing the payload of " << length << " bytes...";
 
-    if (!FileExists(TYPING_FILE))
+    utility::Tokenizer tokens(utility::StringView(payload, length), ';');
+    utility::StringView token, key, value;
+
+    if (!tokens.next(token) || !token.splitPair('=', key, value) || value != "true")
     {
-        result = failure({
-            .context = "GetSensorCredentials",
-            .message = "The file does not exists",
+        return failure({
+            .context = "CredentialsFromBrokerPayload",
+            .message = "The payload is not valid",
         });
     }
-    else
+
+    LOG_TRACE(BROKER) << "Is a success. Parsing credentials...";
+
+    BrokerCredentials credentials;
+
+    while (tokens.next(token))
     {
-        auto openResult = OpenFile(TYPING_FILE, "r");
+        if (!token.splitPair('=', key, value) || key.isEmpty() || value.isEmpty())
+        {
+            continue;
+        }
+
+        BrokerCredential credential = {
+            .key = arena.copy(key.data(), key.length()),
+            .id = arena.copy(value.data(), value.length()),
+        };
 
-        if (!openResult.ok())
+        if (credential.key == nullptr || credential.id == nullptr)
         {
-            result = failure(openResult.error());
+            return failure({
+                .context = "CredentialsFromBrokerPayload",
+                .message = "The message arena is full",
+            });
         }
-        else
+
+        LOG_TRACE(BROKER) << "Adding credential: " << credential.key << " - " << credential.id;
+
+        if (!credentials.add(credential))
         {
-            File file = openResult.unwrap();
-
-            if (file)
-            {
-                String type;
-                String id;
-                SensorCredentials credentials;
-
-                auto readResult = ReadFromFile(TYPING_FILE, '\n');
-
-                if (!readResult.ok())
-                {
-                    result = failure(readResult.error());
-                }
-                else
-                {
-                    auto array = readResult.unwrap();
-
-                    int i = 0;
-
-                    for (; i < array.length(); i++)
-                    {
-                        // odd
-                        if ((i & 1))
-                        {
-                            id = (*array.at(i)).substring(0, (*array.at(i)).length() - 1);
-                            INTERNAL_DEBUG() << "Read id: '" << id << "'";
-                            INTERNAL_DEBUG() << "Reload credential: " << type << " - " << id;
-                            credentials.add({.type = type, .id = id});
-                        }
-                        else
-                        {
-                            type = (*array.at(i)).substring(0, (*array.at(i)).length() - 1);
-                            INTERNAL_DEBUG() << "Read type: '" << type << "'";
-                        }
-                    }
-
-                    // odd values represents unformed pairs
-                    if (i & 1)
-                    {
-                        // clean file for read new values. Forces a new registration.
-                        CleanFile(TYPING_FILE);
-                        CleanFile(ENTRY_FILE);
-
-                        ESP.restart();
-                    }
-                }
-
-                result = ok(credentials);
-            }
-            else
-            {
-                result = failure({
-                    .context = "GetSensorCredentials",
-                    .message = "Opening the file resulted in an error",
-                });
-            }
-
-            file.close();
+            return failure({
+                .context = "CredentialsFromBrokerPayload",
+                .message = "Too many credentials",
+            });
         }
     }
 
-    return result;
+    return ok(credentials);
 }
 
-auto SaveSensorCredentials(SensorCredentials credentials) -> ErrorOr<>
+/**
+ * @brief Get the credentials of the types from the device configuration
+ *
+ * @return ErrorOr<SensorCredentials> can be the credentials or failure()
+ */
+auto GetSensorCredentials() -> ErrorOr<SensorCredentials>
 {
-    ErrorOr<> result = ok();
-
-    INTERNAL_DEBUG()
-        << "Saving sensor credentials";
+    auto &config = deviceConfig.get();
+    SensorCredentials credentials;
 
-    if (!FileExists(TYPING_FILE))
+    for (uint8_t i = 0; i < config.typesLength; i++)
     {
-        CreateFile(TYPING_FILE);
-    }
+        SensorType credential = {.id = config.types[i].id};
+        ParseSensorTypeKey(config.types[i].key, credential);
 
-    auto openResult = OpenFile(TYPING_FILE, "w");
+        LOG_TRACE(BROKER) << "Reload credential: " << int(credential.slave) << ":" << credential.type << " - " << credential.id;
 
-    if (!openResult.ok())
-    {
-        INTERNAL_DEBUG() << "Failed to open file for writing";
-        result = failure(openResult.error());
+        credentials.add(credential);
     }
-    else
-    {
-        File file = openResult.unwrap();
 
-        if (file)
-        {
-            for (auto &credential : credentials)
-            {
-                INTERNAL_DEBUG() << "Saving credential: " << credential.type << " - " << credential.id;
+    return ok(credentials);
+}
 
-                file.println(credential.type);
-                file.println(credential.id);
-            }
-        }
-        else
-        {
-            result = failure({.context = "SaveSensorCredentials", .message = "Opening the file resulted in an error"});
-        }
+/**
+ * @brief Checks if the credentials of the types were saved
+ */
+auto HasSensorCredentials() -> bool
+{
+    return deviceConfig.get().typesLength > 0;
+}
 
-        file.close();
-    }
+/**
+ * @brief Save the credentials of the types on the device configuration
+ *
+ * @param credentials the credentials
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto SaveSensorCredentials(const BrokerCredentials &credentials) -> ErrorOr<>
+{
+    LOG_DEBUG(BROKER) << "Saving sensor credentials";
+
+    return deviceConfig.update([&](DeviceConfig &config) -> bool
+                               {
+                                   config.typesLength = 0;
+
+                                   for (auto &credential : credentials)
+                                   {
+                                       LOG_TRACE(BROKER) << "Saving credential: " << credential.key << " - " << credential.id;
+
+                                       auto &type = config.types[config.typesLength++];
+
+                                       if (!SetDeviceConfigField(type.key, credential.key, strlen(credential.key)) ||
+                                           !SetDeviceConfigField(type.id, credential.id, strlen(credential.id)))
+                                       {
+                                           return false;
+                                       }
+                                   }
 
-    return result;
+                                   return true; },
+                               "SaveSensorCredentials");
 }
 
-#endif // ! _SensorCredentials_h_
\ No newline at end of file
+#endif // ! _SensorCredentials_h_
@@ -23,9 +23,9 @@ auto SyncSensor() -> ErrorOr<>
 {
     ErrorOr<> result = ok();
 
-    if (IsEmptyFile(TYPING_FILE))
+    if (!HasSensorCredentials())
     {
-        if (IsEmptyFile(ENTRY_FILE))
+        if (!HasUserEntry())
         {
             // This function will never return, because the ESP8266 will be restarted by the web server.
             GetUserEntryFromWebServer();
@@ -35,7 +35,7 @@ auto SyncSensor() -> ErrorOr<>
 
         if (!entryResult.ok())
         {
-            INTERNAL_DEBUG() << entryResult.error();
+            LOG_ERROR(BROKER) << entryResult.error();
 
             result = failure({
                 .context = "SyncSensor",
@@ -46,7 +46,7 @@ auto SyncSensor() -> ErrorOr<>
         {
             UserEntry userEntry = entryResult.unwrap();
 
-            if (IsEmptyFile(SELF_FILE))
+            if (!HasSelf())
             {
                 GetSensorIdFromBroker(userEntry);
             }
@@ -55,7 +55,7 @@ auto SyncSensor() -> ErrorOr<>
 
             if (!selfResult.ok())
             {
-                INTERNAL_DEBUG() << selfResult.error();
+                LOG_ERROR(BROKER) << selfResult.error();
 
                 result = failure({
                     .context = "SyncSensor",
@@ -66,14 +66,14 @@ auto SyncSensor() -> ErrorOr<>
             {
                 auto id = selfResult.unwrap();
 
-                if (IsEmptyFile(TYPING_FILE))
+                if (!HasSensorCredentials())
                 {
                     GetSensorCredentialsFromBroker(id);
                 }
 
                 if (!selfResult.ok())
                 {
-                    INTERNAL_DEBUG() << selfResult.error();
+                    LOG_ERROR(BROKER) << selfResult.error();
 
                     result = failure({
                         .context = "SyncSensor",
@@ -13,6 +13,7 @@
 #include <file.h>
 #include <wifi-connection.h>
 #include <wifi-credentials.h>
+#include <user-entry.h>
 
 /**
  * @brief Sync the WiFi credentials by file system
@@ -21,13 +22,13 @@
  */
 auto SyncWiFiByFileSystem() -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing WiFi by file system...";
+    LOG_INFO(WIFI) << "Syncing WiFi by file system...";
 
     auto result = GetWiFiCredentials();
 
     if (!result.ok())
     {
-        INTERNAL_DEBUG() << "Failed to get WiFi credentials: " << result.error();
+        LOG_ERROR(WIFI) << "Failed to get WiFi credentials: " << result.error();
 
         return failure({
             .context = "SyncWiFiByFileSystem",
@@ -35,9 +36,9 @@ auto SyncWiFiByFileSystem() -> ErrorOr<>
         });
     }
 
-    // When this file is empty, ESP does not connect to any wifi,
+    // When there is no user entry, ESP does not connect to any wifi,
     // as it will restart when capturing data through the host
-    if (!IsEmptyFile(ENTRY_FILE))
+    if (HasUserEntry())
     {
         WiFiCredentials credentials = result.unwrap();
 
@@ -23,7 +23,7 @@
  */
 auto GetWiFiCredentialsFromUser() -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing WiFi by local host...";
+    LOG_INFO(PORTAL) << "Syncing WiFi by local host...";
 
     // prepare the WiFi instance to Access Point.
     ConfigureWiFiToWebServer();
@@ -42,7 +42,7 @@ auto GetWiFiCredentialsFromUser() -> ErrorOr<>
     server.begin();
     TurnOnBuiltInLed();
 
-    INTERNAL_DEBUG() << "Server started. Waiting for WiFi credentials...";
+    LOG_INFO(PORTAL) << "Server started. Waiting for WiFi credentials...";
 
     while (true)
     {
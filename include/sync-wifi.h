@@ -20,27 +20,27 @@
  */
 auto SyncWiFi() -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Syncing WiFi...";
+    LOG_INFO(WIFI) << "Syncing WiFi...";
 
     auto result = SyncWiFiByFileSystem();
 
     if (result.ok())
     {
-        INTERNAL_DEBUG() << "Synced by file system";
+        LOG_INFO(WIFI) << "Synced by file system";
         return ok();
     }
 
-    INTERNAL_DEBUG() << result.error();
+    LOG_WARN(WIFI) << result.error();
 
     auto result2 = GetWiFiCredentialsFromUser();
 
     if (result2.ok())
     {
-        INTERNAL_DEBUG() << "Synced by local host";
+        LOG_INFO(WIFI) << "Synced by local host";
         return ok();
     }
 
-    INTERNAL_DEBUG() << result.error();
+    LOG_ERROR(WIFI) << result.error();
 
     return failure({
         .context = "SyncWiFi",
@@ -10,8 +10,9 @@
 #ifndef _UserEntry_h_
 #define _UserEntry_h_
 
-#include <file.h>
-#include <config/file-system.h>
+#include <device-config.h>
+
+#include <Arena.h>
 
 /**
  * @brief The credentials of a user
@@ -25,90 +26,84 @@ struct UserEntry
     String cpf = "";
 
     /**
-     * @brief Convertes the user entry to a JSON string
+     * @brief Convertes the user entry to a JSON string, on an arena
+     *
+     * @param arena the arena of the message
      *
-     * @return The JSON string
+     * @return The JSON string, or nullptr if it does not fit on the arena
      */
-    auto ToJson() -> String
+    auto ToJson(utility::Arena &arena) const -> const char *
     {
-        return String("UserEntry {") +
-               "id: " + id + ", " +
-               "name: " + name + ", " +
-               "password: " + password + ", " +
-               "serialCode: " + serialCode + ", " +
-               "cpf: " + cpf +
-               "}";
+        return arena.format("UserEntry {id: %s, name: %s, password: %s, serialCode: %s, cpf: %s}",
+                            id.c_str(), name.c_str(), password.c_str(), serialCode.c_str(), cpf.c_str());
     }
 };
 
 /**
- * @brief Reads the user entry from the file
+ * @brief Checks if a configuration holds a user entry
 */
-auto GetUserEntry() -> ErrorOr<UserEntry>
+auto HasUserEntry(const DeviceConfig &config) -> bool
 {
-    auto readResult = ReadFromFile(ENTRY_FILE, '\n');
-
-    if (!readResult.ok())
-    {
-        INTERNAL_DEBUG() << "Failed to read the session file.";
-        return failure(readResult.error());
-    }
+    return config.cpf[0] != '\0' || config.name[0] != '\0' || config.password[0] != '\0' || config.serialCode[0] != '\0';
+}
 
-    // unwrap the lines of file.
-    auto lines = readResult.unwrap();
+/**
+ * @brief Reads the user entry from the device configuration
+*/
+auto GetUserEntry() -> ErrorOr<UserEntry>
+{
+    auto &config = deviceConfig.get();
 
-    // check if the file has 4 lines.
-    if (lines.length() != 4)
+    if (!HasUserEntry(config))
     {
-        INTERNAL_DEBUG() << "The session file has not 4 lines.";
+        LOG_WARN(CONFIG) << "There is no user entry.";
         return failure({
             .context = "GetUserEntry",
-            .message = "The session file has not 4 lines",
+            .message = "There is no user entry",
         });
     }
 
-    auto first = *lines.at(0);
-    auto second = *lines.at(1);
-    auto third = *lines.at(2);
-    auto fourth = *lines.at(3);
-
-    // remove the last character of the lines.
     return ok<UserEntry>({
-        .name = second.substring(0, second.length() - 1),
-        .password = third.substring(0, third.length() - 1),
-        .serialCode = fourth.substring(0, fourth.length() - 1),
-        .cpf = first.substring(0, first.length() - 1),
+        .name = config.name,
+        .password = config.password,
+        .serialCode = config.serialCode,
+        .cpf = config.cpf,
     });
 }
 
 /**
- * @brief Saves the user entry to the file
+ * @brief Checks if the user entry was saved
 */
-auto SaveUserEntry(UserEntry &entry) -> ErrorOr<>
+auto HasUserEntry() -> bool
 {
-    INTERNAL_DEBUG() << "Saving user entry...";
-
-    if (!FileExists(ENTRY_FILE))
-    {
-        CreateFile(ENTRY_FILE);
-    }
-
-    auto openResult = OpenFile(ENTRY_FILE, "w");
-
-    if (!openResult.ok())
-    {
-        INTERNAL_DEBUG() << "Failed to open the file.";
-        return failure(openResult.error());
-    }
-
-    File file = openResult.unwrap();
+    return HasUserEntry(deviceConfig.get());
+}
 
-    file.println(entry.cpf);
-    file.println(entry.name);
-    file.println(entry.password);
-    file.println(entry.serialCode);
+/**
+ * @brief Saves the user entry to the device configuration
+*/
+auto SaveUserEntry(UserEntry &entry) -> ErrorOr<>
+{
+    LOG_DEBUG(CONFIG) << "Saving user entry...";
+
+    return deviceConfig.update([&](DeviceConfig &config) -> bool
+                               { return SetDeviceConfigField(config.cpf, entry.cpf) &&
+                                        SetDeviceConfigField(config.name, entry.name) &&
+                                        SetDeviceConfigField(config.password, entry.password) &&
+                                        SetDeviceConfigField(config.serialCode, entry.serialCode); },
+                               "SaveUserEntry");
+}
 
-    return ok();
+/**
+ * @brief Forgets the user entry, so it is asked to the user again
+*/
+auto ClearUserEntry() -> ErrorOr<>
+{
+    return deviceConfig.update([](DeviceConfig &config) -> bool
+                               {
+                                   config.cpf[0] = config.name[0] = config.password[0] = config.serialCode[0] = '\0';
+                                   return true; },
+                               "ClearUserEntry");
 }
 
-#endif // ! _UserEntry_h_
\ No newline at end of file
+#endif // ! _UserEntry_h_
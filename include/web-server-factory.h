@@ -63,13 +63,13 @@ auto MakeWebServerBase() -> AsyncWebServer {
 
     server.on("/shared/style.css", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /style.css";
+                  LOG_DEBUG(PORTAL) << "GET /style.css";
                   request->send(LittleFS, "/public/shared/style.css", "text/css", false);
               });
 
     server.on("/shared/index.js", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /index.js";
+                  LOG_DEBUG(PORTAL) << "GET /index.js";
                   request->send(LittleFS, "/public/shared/index.js", "text/script", false);
               });
 
@@ -79,19 +79,19 @@ auto MakeWebServerBase() -> AsyncWebServer {
 auto ConstructWebServerToWifiConfig(AsyncWebServer &server) -> void {
     server.on("/", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /";
+                  LOG_DEBUG(PORTAL) << "GET /";
                   request->send(LittleFS, "/public/wifi/index.html", "text/html", false);
               });
 
     server.on("/index.js", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /index.js";
+                  LOG_DEBUG(PORTAL) << "GET /index.js";
                   request->send(LittleFS, "/public/wifi/index.js", "text/script", false);
               });
 
     server.on("/", HTTP_POST,
               [&](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "POST /";
+                  LOG_DEBUG(PORTAL) << "POST /";
                   auto *ssid = request->getParam("ssid", true);
                   auto *password = request->getParam("password", true);
 
@@ -103,7 +103,7 @@ auto ConstructWebServerToWifiConfig(AsyncWebServer &server) -> void {
                   auto result = Guard::againstNullBulk(args);
 
                   if (!result.succeeded) {
-                      INTERNAL_DEBUG() << "Guard failed: " << result.message;
+                      LOG_ERROR(PORTAL) << "Guard failed: " << result.message;
                       request->send(400);
                       return;
                   }
@@ -116,7 +116,7 @@ auto ConstructWebServerToWifiConfig(AsyncWebServer &server) -> void {
                   auto saveResult = SaveWiFiCredentials(wifiCredentials);
 
                   if (!saveResult.ok()) {
-                      INTERNAL_DEBUG() << "Failed to save WiFi credentials: " << saveResult.error();
+                      LOG_ERROR(PORTAL) << "Failed to save WiFi credentials: " << saveResult.error();
                       request->send(422);
                       return;
                   }
@@ -129,19 +129,19 @@ auto ConstructWebServerToWifiConfig(AsyncWebServer &server) -> void {
 auto ConstructWebServerToUserCredentialsConfig(AsyncWebServer &server) -> void {
     server.on("/", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /sync";
+                  LOG_DEBUG(PORTAL) << "GET /sync";
                   request->send(LittleFS, "/public/sensor/index.html", String(), false);
               });
 
     server.on("/index.js", HTTP_GET,
               [](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "GET /index.js";
+                  LOG_DEBUG(PORTAL) << "GET /index.js";
                   request->send(LittleFS, "/public/sensor/index.js", "text/script", false);
               });
 
     server.on("/", HTTP_POST,
               [&](AsyncWebServerRequest *request) {
-                  INTERNAL_DEBUG() << "POST /";
+                  LOG_DEBUG(PORTAL) << "POST /";
                   auto *username = request->getParam("username", true);
                   auto *password = request->getParam("password", true);
                   auto *cpf = request->getParam("cpf", true);
@@ -157,7 +157,7 @@ auto ConstructWebServerToUserCredentialsConfig(AsyncWebServer &server) -> void {
                   auto result = Guard::againstNullBulk(args);
 
                   if (!result.succeeded) {
-                      INTERNAL_DEBUG() << "Guard failed: " << result.message;
+                      LOG_ERROR(PORTAL) << "Guard failed: " << result.message;
                       request->send(400);
                       return;
                   }
@@ -172,7 +172,7 @@ auto ConstructWebServerToUserCredentialsConfig(AsyncWebServer &server) -> void {
                   auto result1 = SaveUserEntry(userEntry);
 
                   if (!result1.ok()) {
-                      INTERNAL_DEBUG() << "Failed to save user entry: " << result1.error();
+                      LOG_ERROR(PORTAL) << "Failed to save user entry: " << result1.error();
                       request->send(422);
                       return;
                   }
@@ -39,7 +39,7 @@ struct WiFiCredentials
  */
 auto WiFiConnect(WiFiCredentials &credentials) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Connecting to WiFi...";
+    LOG_DEBUG(WIFI) << "Connecting to WiFi...";
 
     WiFi.mode(WIFI_STA);
 
@@ -63,7 +63,7 @@ auto WiFiConnect(WiFiCredentials &credentials) -> ErrorOr<>
  */
 auto WiFiDisconnect() -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Disconnecting from WiFi...";
+    LOG_DEBUG(WIFI) << "Disconnecting from WiFi...";
     WiFi.disconnect(true);
     return ok();
 }
@@ -10,9 +10,8 @@
 #ifndef _WiFiCredentials_h_
 #define _WiFiCredentials_h_
 
-#include <file.h>
+#include <device-config.h>
 #include <wifi-connection.h>
-#include <config/file-system.h>
 
 /**
  * @brief Get the WiFi credentials
@@ -21,34 +20,20 @@
  */
 auto GetWiFiCredentials() -> ErrorOr<WiFiCredentials>
 {
-    auto readResult = ReadFromFile(SESSION_FILE, '\n');
+    auto &config = deviceConfig.get();
 
-    if (!readResult.ok())
+    if (config.ssid[0] == '\0')
     {
-        INTERNAL_DEBUG() << "Failed to read the session file.";
-        return failure(readResult.error());
-    }
-
-    // unwrap the lines of file.
-    auto lines = readResult.unwrap();
-
-    // check if the file has 2 lines.
-    if (lines.length() != 2)
-    {
-        INTERNAL_DEBUG() << "The session file has not 2 lines.";
+        LOG_WARN(CONFIG) << "There are no WiFi credentials.";
         return failure({
             .context = "GetWiFiCredentials",
-            .message = "The session file has not 2 lines",
+            .message = "There are no WiFi credentials",
         });
     }
 
-    auto first = *lines.at(0);
-    auto second = *lines.at(1);
-
-    // remove the last character of the lines.
     return ok<WiFiCredentials>({
-        .ssid = first.substring(0, first.length() - 1),
-        .password = second.substring(0, second.length() - 1),
+        .ssid = config.ssid,
+        .password = config.wifiPassword,
     });
 }
 
@@ -61,45 +46,26 @@ auto GetWiFiCredentials() -> ErrorOr<WiFiCredentials>
  */
 auto SaveWiFiCredentials(WiFiCredentials credentials) -> ErrorOr<>
 {
-    INTERNAL_DEBUG() << "Saving WiFi credentials...";
-    File file;
-
-    auto createResult = CreateFile(SESSION_FILE);
+    LOG_DEBUG(CONFIG) << "Saving WiFi credentials...";
 
-    if (!createResult.ok())
-    {
-        INTERNAL_DEBUG() << createResult.error();
-        auto openResult = OpenFile(SESSION_FILE, "w");
-
-        if (!openResult.ok())
-        {
-            INTERNAL_DEBUG() << openResult.error();
-            return failure({
-                .context = "SaveWiFiCredentials",
-                .message = "Failed to create and open the file",
-            });
-        }
-
-        INTERNAL_DEBUG() << "File opened.";
-        file = openResult.unwrap();
-    }
-
-    // Can't use else because of the return in the if statement.
-    // Cannot open the file.
-    if (!file)
-    {
-        return failure({
-            .context = "SaveWiFiCredentials",
-            .message = "Failed to open the file",
-        });
-    }
-
-    file.println(credentials.ssid);
-    file.println(credentials.password);
-
-    CloseFile(file);
+    return deviceConfig.update([&](DeviceConfig &config) -> bool
+                               { return SetDeviceConfigField(config.ssid, credentials.ssid) &&
+                                        SetDeviceConfigField(config.wifiPassword, credentials.password); },
+                               "SaveWiFiCredentials");
+}
 
-    return ok();
+/**
+ * @brief Forget the WiFi credentials, so they are asked to the user again
+ *
+ * @return ErrorOr<> can be ok() or failure()
+ */
+auto ClearWiFiCredentials() -> ErrorOr<>
+{
+    return deviceConfig.update([](DeviceConfig &config) -> bool
+                               {
+                                   config.ssid[0] = config.wifiPassword[0] = '\0';
+                                   return true; },
+                               "ClearWiFiCredentials");
 }
 
-#endif // ! _WiFiCredentials_h_
\ No newline at end of file
+#endif // ! _WiFiCredentials_h_
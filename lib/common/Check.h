@@ -12,6 +12,7 @@
 #define _Check_h
 
 #include <Internal.h>
+#include <Log.h>
 
 // Checks the given condition, and if it's false, streams the
 // error message, then exits. This should be used for unexpected errors, such as
@@ -37,12 +38,11 @@
 
 // Unlike CHECK, this does not abort the application,
 // it only displays the debug message, making it easier
-// to trace the application.
+// to trace the application. Kept for the older code, new
+// code states its level and module through Log.h.
 //
 // For example:
 //   INTERNAL_DEBUG() << "Safe block!";
-#define INTERNAL_DEBUG() check_internal_debug()                                                  \
-                             << "DEBUG at " << __FILE__ << ":" << __LINE__ \
-                             << internal::ExitingStream::AddSeparator()
+#define INTERNAL_DEBUG() LOG_DEBUG(APP)
 
 #endif // ! _Check_h
@@ -22,10 +22,10 @@ struct Error
 
     static Error None;
 
-    friend auto operator<<(internal::ExitingStream stream, Error e) -> internal::ExitingStream&;
+    friend auto operator<<(internal::ExitingStream &stream, Error e) -> internal::ExitingStream&;
 };
 
-auto operator<<(internal::ExitingStream stream, Error e) -> internal::ExitingStream&
+auto operator<<(internal::ExitingStream &stream, Error e) -> internal::ExitingStream&
 {
     return stream << "Error{" << e.context << ":" << e.message << "}";
 }
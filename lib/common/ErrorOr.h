@@ -198,7 +198,11 @@ public:
         ok_ = true;
     }
 
-    ErrorOr(const ErrorOr &other) {}
+    ErrorOr(const ErrorOr &other)
+        : ok_(other.ok_),
+          error_(other.error_)
+    {
+    }
 
     ErrorOr(ErrorOr &&other) : ErrorOr(other) {}
 
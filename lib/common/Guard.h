@@ -11,6 +11,7 @@
 #define _Guard_h_
 
 #include <LinkedList.h>
+#include <StaticVector.h>
 #include <ErrorOr.h>
 
 #include <WString.h>
@@ -36,8 +37,15 @@ struct IGuardArgument
     ~IGuardArgument() = default;
 };
 
-typedef LL<IGuardResult> GuardResultCollection;
-typedef LL<IGuardArgument> GuardArgumentCollection;
+/**
+ * @brief Largest number of arguments, and of results, checked at once.
+ */
+#ifndef GUARD_COLLECTION_CAPACITY
+#define GUARD_COLLECTION_CAPACITY 8
+#endif // ! GUARD_COLLECTION_CAPACITY
+
+typedef utility::StaticVector<IGuardResult, GUARD_COLLECTION_CAPACITY> GuardResultCollection;
+typedef utility::StaticVector<IGuardArgument, GUARD_COLLECTION_CAPACITY> GuardArgumentCollection;
 
 class Guard
 {
@@ -56,7 +64,7 @@ public:
         return {.succeeded = true};
     }
 
-    static auto againstNullBulk(GuardArgumentCollection args) -> IGuardResult
+    static auto againstNullBulk(const GuardArgumentCollection &args) -> IGuardResult
     {
         GuardResultCollection results = GuardResultCollection();
 
@@ -73,11 +81,11 @@ public:
     }
 
     template <typename T>
-    static auto isOneOf(IGuardArgument arg, LL<T> validValues) -> IGuardResult
+    static auto isOneOf(IGuardArgument arg, const LL<T> &validValues) -> IGuardResult
     {
         auto value = static_cast<T>(arg.any);
 
-        for (auto validValue : validValues)
+        for (const auto &validValue : validValues)
         {
             if (*value == validValue)
             {
@@ -107,7 +115,7 @@ public:
     }
 
     static auto allInRange(
-        LL<int> args,
+        const LL<int> &args,
         int min,
         int max,
         String argumentName) -> IGuardResult
@@ -115,7 +123,7 @@ public:
         IGuardResult result = {};
         GuardResultCollection results = GuardResultCollection();
 
-        for (auto num : args)
+        for (auto &num : args)
         {
             result = Guard::inRange(num, min, max, String("") + num);
             if (!result.succeeded)
@@ -133,11 +141,11 @@ public:
         return {.succeeded = true};
     }
 
-    static auto combine(GuardResultCollection results) -> IGuardResult
+    static auto combine(const GuardResultCollection &results) -> IGuardResult
     {
         IGuardResult fusion{.succeeded = true};
 
-        for (auto result : results)
+        for (auto &result : results)
         {
             fusion = IGuardResult{
                 .succeeded = fusion.succeeded && result.succeeded,
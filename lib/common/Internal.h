@@ -17,6 +17,19 @@
 
 #include <type_traits>
 
+// The serial receiving the debug output. Build with -D DEBUG_SERIAL=Serial1 when
+// UART0 is taken by another peripheral.
+#ifndef DEBUG_SERIAL
+#define DEBUG_SERIAL Serial
+#define DEBUG_SERIAL_IS_UART0
+#endif // ! DEBUG_SERIAL
+
+// The baud rate of the debug output. Printing blocks once the UART buffer is full, so a
+// slower rate stalls the loop for longer on each line.
+#ifndef DEBUG_SERIAL_BAUD
+#define DEBUG_SERIAL_BAUD 9600
+#endif // ! DEBUG_SERIAL_BAUD
+
 namespace internal
 {
     // Wraps a stream and exiting for FATAL errors. Should only be used by Check.h
@@ -62,6 +75,7 @@ namespace internal
                                   std::disjunction_v<
                                       std::is_same<T, char *>,
                                       std::is_same<T, const char *>,
+                                      std::is_same<T, const __FlashStringHelper *>,
                                       std::is_same<T, String>,
                                       std::is_same<T, char>,
                                       std::is_same<T, int>,
@@ -113,7 +127,7 @@ namespace internal
             buffer_.concat("\n");
 
             // Print's the error message.
-            Serial.print(buffer_);
+            DEBUG_SERIAL.print(buffer_);
 
             // It's useful to exit the program with `std::abort()` for integration with
             // debuggers and other tools.
@@ -125,7 +139,7 @@ namespace internal
             buffer_.concat("\n");
 
             // Print's the error message.
-            Serial.print(buffer_);
+            DEBUG_SERIAL.print(buffer_);
 
             buffer_ = "";
         }
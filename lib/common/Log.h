@@ -0,0 +1,85 @@
+/**
+ * @file Log.h
+ * @brief Compile-time log levels
+ * @details This file contains the log levels and the per-module filters of the debug output.
+ * A statement below the level of its module is a constant false branch, so it compiles to
+ * nothing, its arguments included, and the file names of the statements left are kept in
+ * flash. Every level and filter can be set by the build, e.g.
+ *
+ *   -D LOG_LEVEL=LOG_LEVEL_WARN -D LOG_MODULE_MEASURE=LOG_LEVEL_TRACE
+ *
+ * prints the warnings and errors of every module, and everything of the measures.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#ifndef _Log_h_
+#define _Log_h_
+
+#include <Internal.h>
+
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_NONE 5
+
+/**
+ * @brief Lowest level printed by the modules without a level of their own.
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif // ! LOG_LEVEL
+
+/**
+ * @brief Lowest level printed by each module.
+ */
+#ifndef LOG_MODULE_APP
+#define LOG_MODULE_APP LOG_LEVEL
+#endif // ! LOG_MODULE_APP
+
+#ifndef LOG_MODULE_CONFIG
+#define LOG_MODULE_CONFIG LOG_LEVEL
+#endif // ! LOG_MODULE_CONFIG
+
+#ifndef LOG_MODULE_STORAGE
+#define LOG_MODULE_STORAGE LOG_LEVEL
+#endif // ! LOG_MODULE_STORAGE
+
+#ifndef LOG_MODULE_WIFI
+#define LOG_MODULE_WIFI LOG_LEVEL
+#endif // ! LOG_MODULE_WIFI
+
+#ifndef LOG_MODULE_PORTAL
+#define LOG_MODULE_PORTAL LOG_LEVEL
+#endif // ! LOG_MODULE_PORTAL
+
+#ifndef LOG_MODULE_BROKER
+#define LOG_MODULE_BROKER LOG_LEVEL
+#endif // ! LOG_MODULE_BROKER
+
+#ifndef LOG_MODULE_MEASURE
+#define LOG_MODULE_MEASURE LOG_LEVEL
+#endif // ! LOG_MODULE_MEASURE
+
+// Streams a message of a level of a module, printed if the module prints the level.
+//
+// For example:
+//   LOG(INFO, WIFI) << "Connected";
+#define LOG(level, module) (LOG_LEVEL_##level < LOG_MODULE_##module) ? (void)0                         \
+                                                                     : check_internal_debug()          \
+                                                                           << F(#level " at ")         \
+                                                                           << F(__FILE__) << ":"       \
+                                                                           << __LINE__                 \
+                                                                           << internal::ExitingStream::AddSeparator()
+
+#define LOG_TRACE(module) LOG(TRACE, module)
+#define LOG_DEBUG(module) LOG(DEBUG, module)
+#define LOG_INFO(module) LOG(INFO, module)
+#define LOG_WARN(module) LOG(WARN, module)
+#define LOG_ERROR(module) LOG(ERROR, module)
+
+#endif // ! _Log_h_
@@ -0,0 +1,164 @@
+/**
+ * @file Arena.h
+ * @brief This file contains the implementation of the Arena class.
+ * @details This file contains the implementation of a bump pointer arena. Allocating moves a
+ * pointer forward and freeing is done all at once, by rewinding the pointer, so a burst of
+ * short-lived allocations leaves no hole behind on the heap. Nothing allocated on the arena
+ * is destroyed, so it only holds trivially destructible types.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_ARENA
+#define ESP8266_ARENA
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace utility
+{
+    class Arena
+    {
+        unsigned char *_buffer;
+        size_t _capacity;
+        size_t _used = 0;
+        size_t _highWater = 0;
+
+    public:
+        Arena(void *buffer, size_t capacity) : _buffer(static_cast<unsigned char *>(buffer)), _capacity(capacity) {}
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        // Allocates `size` bytes aligned to `alignment`, or nullptr if they do not fit.
+        void *allocate(size_t size, size_t alignment = alignof(max_align_t))
+        {
+            auto address = reinterpret_cast<uintptr_t>(_buffer) + _used;
+            auto padding = (alignment - address % alignment) % alignment;
+
+            if (padding + size > _capacity - _used)
+            {
+                return nullptr;
+            }
+
+            auto block = _buffer + _used + padding;
+
+            _used += padding + size;
+
+            if (_used > _highWater)
+            {
+                _highWater = _used;
+            }
+
+            return block;
+        }
+
+        // Allocates an array of `length` items, or nullptr if it does not fit.
+        template <typename T>
+        T *allocate(size_t length)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "Arena items are never destroyed");
+
+            return static_cast<T *>(allocate(length * sizeof(T), alignof(T)));
+        }
+
+        // Constructs an item, or returns nullptr if it does not fit.
+        template <typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            auto block = allocate<T>(1);
+
+            return block != nullptr ? new (block) T(std::forward<Args>(args)...) : nullptr;
+        }
+
+        // Copies `length` chars, null terminated, or returns nullptr if they do not fit.
+        char *copy(const char *text, size_t length)
+        {
+            auto block = allocate<char>(length + 1);
+
+            if (block != nullptr)
+            {
+                memcpy(block, text, length);
+                block[length] = '\0';
+            }
+
+            return block;
+        }
+
+        // Formats a null terminated text, as printf() does, or returns nullptr if it does not fit.
+        char *format(const char *format, ...) __attribute__((format(printf, 2, 3)))
+        {
+            va_list args;
+
+            va_start(args, format);
+            auto length = vsnprintf(nullptr, 0, format, args);
+            va_end(args);
+
+            auto block = length < 0 ? nullptr : allocate<char>(length + 1);
+
+            if (block != nullptr)
+            {
+                va_start(args, format);
+                vsnprintf(block, length + 1, format, args);
+                va_end(args);
+            }
+
+            return block;
+        }
+
+        // Returns the position to rewind() to.
+        size_t mark() const { return _used; }
+
+        // Frees everything allocated since `mark`.
+        void rewind(size_t mark)
+        {
+            if (mark < _used)
+            {
+                _used = mark;
+            }
+        }
+
+        void reset() { _used = 0; }
+
+        size_t used() const { return _used; }
+
+        size_t capacity() const { return _capacity; }
+
+        // Returns the most bytes ever in use, to size the arena.
+        size_t highWater() const { return _highWater; }
+    };
+
+    // An arena with its N bytes inline.
+    template <size_t N>
+    class StaticArena : public Arena
+    {
+        alignas(max_align_t) unsigned char _storage[N];
+
+    public:
+        StaticArena() : Arena(_storage, N) {}
+    };
+
+    // Frees everything allocated on the arena during its lifetime.
+    class ArenaScope
+    {
+        Arena &_arena;
+        size_t _mark;
+
+    public:
+        explicit ArenaScope(Arena &arena) : _arena(arena), _mark(arena.mark()) {}
+
+        ArenaScope(const ArenaScope &) = delete;
+        ArenaScope &operator=(const ArenaScope &) = delete;
+
+        ~ArenaScope() { _arena.rewind(_mark); }
+    };
+}
+
+#endif // ! ESP8266_ARENA
@@ -0,0 +1,41 @@
+/**
+ * @file Crc32.h
+ * @brief This file contains the implementation of the CRC-32 checksum.
+ * @details This file contains a bitwise CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320).
+ * It trades speed for the 1 KB a lookup table would take, the checked records are small.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_CRC32
+#define ESP8266_CRC32
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utility
+{
+    // Continues a CRC-32 over `length` bytes. Pass the result of a previous call as `crc`
+    // to checksum data in pieces.
+    inline uint32_t crc32(const void *data, size_t length, uint32_t crc = 0)
+    {
+        auto bytes = static_cast<const uint8_t *>(data);
+
+        crc = ~crc;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            crc ^= bytes[i];
+
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+            }
+        }
+
+        return ~crc;
+    }
+}
+
+#endif // !ESP8266_CRC32
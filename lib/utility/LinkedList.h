@@ -1,15 +1,24 @@
 /**
  * @file LinkedList.h
  * @brief This file contains the implementation of the LinkedList class.
- * @details This file contains the implementation of the LinkedList class
+ * @details This file contains the implementation of the LinkedList class. The list owns its
+ * nodes: they are released when it goes out of scope, a copy duplicates them and a move
+ * takes them over. Nodes come from the Allocator, the heap by default, or a NodePool so
+ * short-lived lists never touch malloc.
  * @author Higor Grigorio <higorgrigorio@gmail.com>
  * @version 1.0.0
  * @date 2023-07-10
- * 
+ *
 */
 #ifndef ESP8266_LINKED_LIST
 #define ESP8266_LINKED_LIST
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+#include <utility>
+
 namespace utility
 {
     template <typename T>
@@ -19,13 +28,101 @@ namespace utility
 
     public:
         LinkedListNode<T> *next;
-        LinkedListNode(const T val) : _value(val), next(nullptr) {}
+        LinkedListNode(const T &val) : _value(val), next(nullptr) {}
+        LinkedListNode(T &&val) : _value(std::move(val)), next(nullptr) {}
         ~LinkedListNode() {}
         const T &value() const { return _value; };
         T &value() { return _value; }
     };
 
-    template <typename T, template <typename> class Item = LinkedListNode>
+    // Allocates the nodes on the heap.
+    class HeapAllocator
+    {
+    public:
+        static void *allocate(size_t size) { return malloc(size); }
+
+        static void deallocate(void *block) { ::free(block); }
+    };
+
+    // Allocates blocks of up to SIZE bytes from a static pool of N blocks, shared by every
+    // list of the same pool, and from the heap once the pool is exhausted.
+    template <size_t SIZE, size_t N>
+    class NodePool
+    {
+        static_assert(N > 0, "NodePool capacity must be positive");
+
+        union Block
+        {
+            Block *next;
+            alignas(max_align_t) unsigned char bytes[SIZE];
+        };
+
+        static Block _blocks[N];
+        static Block *_free;
+        static size_t _used;
+        static bool _ready;
+
+    public:
+        static void *allocate(size_t size)
+        {
+            if (!_ready)
+            {
+                for (size_t i = 0; i < N; i++)
+                {
+                    _blocks[i].next = i + 1 < N ? &_blocks[i + 1] : nullptr;
+                }
+
+                _free = _blocks;
+                _ready = true;
+            }
+
+            if (size > SIZE || _free == nullptr)
+            {
+                return malloc(size);
+            }
+
+            auto block = _free;
+            _free = block->next;
+            _used++;
+            return block;
+        }
+
+        static void deallocate(void *block)
+        {
+            auto address = reinterpret_cast<uintptr_t>(block);
+
+            if (address < reinterpret_cast<uintptr_t>(_blocks) ||
+                address >= reinterpret_cast<uintptr_t>(_blocks + N))
+            {
+                ::free(block);
+                return;
+            }
+
+            auto pooled = static_cast<Block *>(block);
+            pooled->next = _free;
+            _free = pooled;
+            _used--;
+        }
+
+        // Returns the number of blocks of the pool in use.
+        static size_t used() { return _used; }
+
+        static constexpr size_t capacity() { return N; }
+    };
+
+    template <size_t SIZE, size_t N>
+    typename NodePool<SIZE, N>::Block NodePool<SIZE, N>::_blocks[N];
+
+    template <size_t SIZE, size_t N>
+    typename NodePool<SIZE, N>::Block *NodePool<SIZE, N>::_free = nullptr;
+
+    template <size_t SIZE, size_t N>
+    size_t NodePool<SIZE, N>::_used = 0;
+
+    template <size_t SIZE, size_t N>
+    bool NodePool<SIZE, N>::_ready = false;
+
+    template <typename T, template <typename> class Item = LinkedListNode, typename Allocator = HeapAllocator>
     class LinkedList
     {
     public:
@@ -35,81 +132,191 @@ namespace utility
     private:
         ItemType *_root;
         ItemType *_end;
+        int _size;
 
-        class Iterator
+        template <typename Value>
+        class BasicIterator
         {
             ItemType *_node;
             ItemType *_nextNode = nullptr;
 
         public:
-            Iterator(ItemType *current = nullptr) : _node(current)
+            // the next node is kept, so the current one can be removed while iterating.
+            BasicIterator(ItemType *current = nullptr) : _node(current)
             {
                 if (_node != nullptr)
                 {
                     _nextNode = current->next;
                 }
             }
-            Iterator(const Iterator &i) : _node(i._node) {}
-            Iterator &operator++()
+            BasicIterator &operator++()
             {
                 _node = _nextNode;
                 _nextNode = _node != nullptr ? _node->next : nullptr;
                 return *this;
             }
-            bool operator!=(const Iterator &i) const { return _node != i._node; }
-            const T &operator*() const { return _node->value(); }
-            const T *operator->() const { return &_node->value(); }
+            bool operator!=(const BasicIterator &i) const { return _node != i._node; }
+            Value &operator*() const { return _node->value(); }
+            Value *operator->() const { return &_node->value(); }
         };
 
+        template <typename Value>
+        ItemType *createItem(Value &&value)
+        {
+            auto memory = Allocator::allocate(sizeof(ItemType));
+
+            if (memory == nullptr)
+            {
+                return nullptr;
+            }
+
+            return new (memory) ItemType(std::forward<Value>(value));
+        }
+
+        static void destroyItem(ItemType *item)
+        {
+            item->~ItemType();
+            Allocator::deallocate(item);
+        }
+
+        template <typename Value>
+        void append(Value &&value)
+        {
+            auto item = createItem(std::forward<Value>(value));
+
+            if (item == nullptr)
+            {
+                return;
+            }
+
+            if (!_root)
+            {
+                _root = _end = item;
+            }
+            else
+            {
+                _end = _end->next = item;
+            }
+
+            _size++;
+        }
+
+        // Unlinks `it`, which follows `pit`, or is the root when `pit` is null, and frees it.
+        void unlink(ItemType *pit, ItemType *it)
+        {
+            if (pit == nullptr)
+            {
+                _root = it->next;
+            }
+            else
+            {
+                pit->next = it->next;
+            }
+
+            if (it == _end)
+            {
+                _end = pit;
+            }
+
+            _size--;
+            destroyItem(it);
+        }
+
     public:
-        typedef const Iterator ConstIterator;
+        typedef BasicIterator<T> Iterator;
+        typedef BasicIterator<const T> ConstIterator;
+
         ConstIterator constBegin() const { return ConstIterator(_root); }
         ConstIterator constEnd() const { return ConstIterator(nullptr); }
 
-        Iterator begin() const { return Iterator(_root); }
-        Iterator end() const { return Iterator(nullptr); }
+        Iterator begin() { return Iterator(_root); }
+        Iterator end() { return Iterator(nullptr); }
+
+        ConstIterator begin() const { return ConstIterator(_root); }
+        ConstIterator end() const { return ConstIterator(nullptr); }
 
         LinkedList()
             : _root(nullptr),
-              _end(nullptr) {};
-        ~LinkedList() {}
+              _end(nullptr),
+              _size(0) {};
 
-        void add(T &&t)
+        LinkedList(const LinkedList &other) : LinkedList()
         {
-            this->add(t);
+            for (const auto &value : other)
+            {
+                add(value);
+            }
         }
 
-        void add(T &t)
+        LinkedList(LinkedList &&other)
+            : _root(other._root),
+              _end(other._end),
+              _size(other._size)
         {
-            auto value = new ItemType(t);
-            if (!_root)
-            {
-                _root = _end = value;
-            }
-            else
+            other._root = other._end = nullptr;
+            other._size = 0;
+        }
+
+        ~LinkedList() { free(); }
+
+        LinkedList &operator=(const LinkedList &other)
+        {
+            if (this != &other)
             {
-                _end = _end->next = value;
+                free();
+
+                for (const auto &value : other)
+                {
+                    add(value);
+                }
             }
+
+            return *this;
         }
 
-        void add(T *array, int size)
+        LinkedList &operator=(LinkedList &&other)
         {
-            for (int i = 0; i < size; ++i)
+            if (this != &other)
             {
-                add(array[i]);
+                free();
+
+                _root = other._root;
+                _end = other._end;
+                _size = other._size;
+
+                other._root = other._end = nullptr;
+                other._size = 0;
             }
+
+            return *this;
         }
 
-        T &front() const
+        void add(T &&t)
         {
-            return _root->value();
+            append(std::move(t));
         }
 
-        T &back() const
+        void add(const T &t)
         {
-            return _end->value();
+            append(t);
         }
 
+        void add(const T *array, int size)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                add(array[i]);
+            }
+        }
+
+        T &front() { return _root->value(); }
+
+        const T &front() const { return _root->value(); }
+
+        T &back() { return _end->value(); }
+
+        const T &back() const { return _end->value(); }
+
         bool isEmpty() const
         {
             return _root == nullptr;
@@ -117,14 +324,7 @@ namespace utility
 
         int length() const
         {
-            int i = 0;
-            auto it = _root;
-            while (it)
-            {
-                i++;
-                it = it->next;
-            }
-            return i;
+            return _size;
         }
 
         int countIf(Predicate predicate) const
@@ -161,27 +361,13 @@ namespace utility
 
         bool remove(const T &t)
         {
-            auto it = _root;
-            auto pit = _root;
+            ItemType *it = _root;
+            ItemType *pit = nullptr;
             while (it)
             {
                 if (it->value() == t)
                 {
-                    if (it == _root)
-                    {
-                        _root = _root->next;
-                    }
-                    else
-                    {
-                        pit->next = it->next;
-                    }
-
-                    if (it == _end)
-                    {
-                        _end = pit;
-                    }
-
-                    delete it;
+                    unlink(pit, it);
                     return true;
                 }
                 pit = it;
@@ -192,22 +378,13 @@ namespace utility
 
         bool removeFirst(Predicate predicate)
         {
-            auto it = _root;
-            auto pit = _root;
+            ItemType *it = _root;
+            ItemType *pit = nullptr;
             while (it)
             {
                 if (predicate(it->value()))
                 {
-                    if (it == _root)
-                    {
-                        _root = _root->next;
-                    }
-                    else
-                    {
-                        pit->next = it->next;
-                    }
-
-                    delete it;
+                    unlink(pit, it);
                     return true;
                 }
                 pit = it;
@@ -224,37 +401,25 @@ namespace utility
 
             while (it)
             {
+                auto next = it->next;
+
                 if (predicate(it->value()))
                 {
-                    if (it == _root)
-                    {
-                        _root = _root->next;
-                    }
-                    else
-                    {
-                        if (it == _end)
-                        { // end element
-                            pit->next = nullptr;
-                            _end = pit;
-                        }
-                        else
-                        { // middle element
-                            pit->next = it->next;
-                        }
-                    }
+                    unlink(pit, it);
                     count++;
-                    delete it;
-                    it = pit->next;
-                    continue;
                 }
-                pit = it;
-                it = it->next;
+                else
+                {
+                    pit = it;
+                }
+
+                it = next;
             }
 
             return count;
         }
 
-        int indexOf(const T &value)
+        int indexOf(const T &value) const
         {
             auto it = _root;
             auto index = 0;
@@ -272,18 +437,16 @@ namespace utility
             return -1;
         }
 
-        LinkedList filter(Predicate predicate)
+        LinkedList filter(Predicate predicate) const
         {
-            auto list = LinkedList<T>();
+            LinkedList list;
             auto it = _root;
 
             while (it)
             {
-                T value = it->value();
-
-                if (predicate(value))
+                if (predicate(it->value()))
                 {
-                    list.add(value);
+                    list.add(it->value());
                 }
                 it = it->next;
             }
@@ -297,11 +460,16 @@ namespace utility
             {
                 auto it = _root;
                 _root = _root->next;
-                delete it;
+                destroyItem(it);
             }
             _root = _end = nullptr;
+            _size = 0;
         }
     };
+
+    // A list whose nodes come from a pool of N nodes.
+    template <typename T, size_t N>
+    using PooledLinkedList = LinkedList<T, LinkedListNode, NodePool<sizeof(LinkedListNode<T>), N>>;
 }
 
 template <typename T>
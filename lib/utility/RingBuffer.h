@@ -0,0 +1,65 @@
+/**
+ * @file RingBuffer.h
+ * @brief This file contains the implementation of the RingBuffer class.
+ * @details This file contains the implementation of a fixed capacity ring buffer that
+ * overwrites its oldest item when full. It never allocates.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ * 
+*/
+#ifndef ESP8266_RING_BUFFER
+#define ESP8266_RING_BUFFER
+
+#include <stddef.h>
+
+namespace utility
+{
+    template <typename T, size_t N>
+    class RingBuffer
+    {
+        static_assert(N > 0, "RingBuffer capacity must be positive");
+
+        T _items[N] = {};
+        size_t _head = 0;
+        size_t _size = 0;
+
+    public:
+        // Appends an item, dropping the oldest one when full.
+        void push(const T &value)
+        {
+            _items[(_head + _size) % N] = value;
+
+            if (_size < N)
+            {
+                _size++;
+            }
+            else
+            {
+                _head = (_head + 1) % N;
+            }
+        }
+
+        // Returns the item at `pos`, 0 being the oldest.
+        const T &operator[](size_t pos) const
+        {
+            return _items[(_head + pos) % N];
+        }
+
+        size_t length() const { return _size; }
+
+        constexpr size_t capacity() const { return N; }
+
+        bool isEmpty() const { return _size == 0; }
+
+        bool isFull() const { return _size == N; }
+
+        void clear()
+        {
+            _head = 0;
+            _size = 0;
+        }
+    };
+}
+
+#endif // ! ESP8266_RING_BUFFER
@@ -0,0 +1,219 @@
+/**
+ * @file SmallVector.h
+ * @brief This file contains the implementation of the SmallVector class.
+ * @details This file contains the implementation of a vector that keeps its first N items
+ * inside the object and only moves to the heap past them, doubling its capacity on each
+ * growth. Sized for the usual case, it costs no allocation at all, and the rare larger one
+ * costs a few instead of one per item.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_SMALL_VECTOR
+#define ESP8266_SMALL_VECTOR
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include <utility>
+
+namespace utility
+{
+    template <typename T, size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector inline capacity must be positive");
+
+        // items are only constructed up to `_size`.
+        alignas(T) unsigned char _storage[N * sizeof(T)];
+        T *_items = reinterpret_cast<T *>(_storage);
+        size_t _size = 0;
+        size_t _capacity = N;
+
+        bool isInline() const { return _items == reinterpret_cast<const T *>(_storage); }
+
+        // Moves the items to a buffer of `capacity` items, false if it cannot be allocated.
+        bool grow(size_t capacity)
+        {
+            auto items = static_cast<T *>(malloc(capacity * sizeof(T)));
+
+            if (items == nullptr)
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < _size; i++)
+            {
+                new (items + i) T(std::move(_items[i]));
+                _items[i].~T();
+            }
+
+            if (!isInline())
+            {
+                free(_items);
+            }
+
+            _items = items;
+            _capacity = capacity;
+            return true;
+        }
+
+        void steal(SmallVector &other)
+        {
+            if (other.isInline())
+            {
+                for (auto &item : other)
+                {
+                    add(std::move(item));
+                }
+
+                other.clear();
+                return;
+            }
+
+            _items = other._items;
+            _size = other._size;
+            _capacity = other._capacity;
+
+            other._items = reinterpret_cast<T *>(other._storage);
+            other._size = 0;
+            other._capacity = N;
+        }
+
+        void release()
+        {
+            clear();
+
+            if (!isInline())
+            {
+                free(_items);
+                _items = reinterpret_cast<T *>(_storage);
+                _capacity = N;
+            }
+        }
+
+    public:
+        SmallVector() = default;
+
+        SmallVector(const SmallVector &other)
+        {
+            reserve(other._size);
+
+            for (const auto &item : other)
+            {
+                add(item);
+            }
+        }
+
+        SmallVector(SmallVector &&other) { steal(other); }
+
+        ~SmallVector() { release(); }
+
+        SmallVector &operator=(const SmallVector &other)
+        {
+            if (this != &other)
+            {
+                clear();
+                reserve(other._size);
+
+                for (const auto &item : other)
+                {
+                    add(item);
+                }
+            }
+
+            return *this;
+        }
+
+        SmallVector &operator=(SmallVector &&other)
+        {
+            if (this != &other)
+            {
+                release();
+                steal(other);
+            }
+
+            return *this;
+        }
+
+        // Makes room for `capacity` items, false if it cannot be allocated.
+        bool reserve(size_t capacity)
+        {
+            return capacity <= _capacity || grow(capacity);
+        }
+
+        // Appends an item, false if the heap is out of memory.
+        bool add(const T &value)
+        {
+            if (_size == _capacity && !grow(_capacity * 2))
+            {
+                return false;
+            }
+
+            new (_items + _size) T(value);
+            _size++;
+            return true;
+        }
+
+        bool add(T &&value)
+        {
+            if (_size == _capacity && !grow(_capacity * 2))
+            {
+                return false;
+            }
+
+            new (_items + _size) T(std::move(value));
+            _size++;
+            return true;
+        }
+
+        // Returns the item at `pos`, or nullptr if it is out of range.
+        T *at(size_t pos) { return pos < _size ? _items + pos : nullptr; }
+
+        const T *at(size_t pos) const { return pos < _size ? _items + pos : nullptr; }
+
+        // Returns the item at `pos`.
+        // REQUIRES: `pos` is less than `length()`.
+        T &operator[](size_t pos) { return _items[pos]; }
+
+        const T &operator[](size_t pos) const { return _items[pos]; }
+
+        T &front() { return _items[0]; }
+
+        const T &front() const { return _items[0]; }
+
+        T &back() { return _items[_size - 1]; }
+
+        const T &back() const { return _items[_size - 1]; }
+
+        T *begin() { return _items; }
+
+        T *end() { return _items + _size; }
+
+        const T *begin() const { return _items; }
+
+        const T *end() const { return _items + _size; }
+
+        T *data() { return _items; }
+
+        const T *data() const { return _items; }
+
+        size_t length() const { return _size; }
+
+        size_t capacity() const { return _capacity; }
+
+        bool isEmpty() const { return _size == 0; }
+
+        // Drops the items, keeping the heap buffer if any.
+        void clear()
+        {
+            while (_size > 0)
+            {
+                _items[--_size].~T();
+            }
+        }
+    };
+}
+
+#endif // ! ESP8266_SMALL_VECTOR
@@ -0,0 +1,159 @@
+/**
+ * @file StaticVector.h
+ * @brief This file contains the implementation of the StaticVector class.
+ * @details This file contains the implementation of a vector of fixed capacity whose items
+ * live inside the object. Length and indexing are O(1), and it never allocates: an add past
+ * the capacity is refused.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_STATIC_VECTOR
+#define ESP8266_STATIC_VECTOR
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+namespace utility
+{
+    template <typename T, size_t N>
+    class StaticVector
+    {
+        static_assert(N > 0, "StaticVector capacity must be positive");
+
+        // items are only constructed up to `_size`.
+        alignas(T) unsigned char _storage[N * sizeof(T)];
+        size_t _size = 0;
+
+    public:
+        StaticVector() = default;
+
+        StaticVector(const StaticVector &other)
+        {
+            for (const auto &item : other)
+            {
+                add(item);
+            }
+        }
+
+        StaticVector(StaticVector &&other)
+        {
+            for (auto &item : other)
+            {
+                add(std::move(item));
+            }
+
+            other.clear();
+        }
+
+        ~StaticVector() { clear(); }
+
+        StaticVector &operator=(const StaticVector &other)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                for (const auto &item : other)
+                {
+                    add(item);
+                }
+            }
+
+            return *this;
+        }
+
+        StaticVector &operator=(StaticVector &&other)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                for (auto &item : other)
+                {
+                    add(std::move(item));
+                }
+
+                other.clear();
+            }
+
+            return *this;
+        }
+
+        // Appends an item, false if the vector is full.
+        bool add(const T &value)
+        {
+            if (_size == N)
+            {
+                return false;
+            }
+
+            new (data() + _size) T(value);
+            _size++;
+            return true;
+        }
+
+        bool add(T &&value)
+        {
+            if (_size == N)
+            {
+                return false;
+            }
+
+            new (data() + _size) T(std::move(value));
+            _size++;
+            return true;
+        }
+
+        // Returns the item at `pos`, or nullptr if it is out of range.
+        T *at(size_t pos) { return pos < _size ? data() + pos : nullptr; }
+
+        const T *at(size_t pos) const { return pos < _size ? data() + pos : nullptr; }
+
+        // Returns the item at `pos`.
+        // REQUIRES: `pos` is less than `length()`.
+        T &operator[](size_t pos) { return data()[pos]; }
+
+        const T &operator[](size_t pos) const { return data()[pos]; }
+
+        T &front() { return data()[0]; }
+
+        const T &front() const { return data()[0]; }
+
+        T &back() { return data()[_size - 1]; }
+
+        const T &back() const { return data()[_size - 1]; }
+
+        T *begin() { return data(); }
+
+        T *end() { return data() + _size; }
+
+        const T *begin() const { return data(); }
+
+        const T *end() const { return data() + _size; }
+
+        T *data() { return reinterpret_cast<T *>(_storage); }
+
+        const T *data() const { return reinterpret_cast<const T *>(_storage); }
+
+        size_t length() const { return _size; }
+
+        constexpr size_t capacity() const { return N; }
+
+        bool isEmpty() const { return _size == 0; }
+
+        bool isFull() const { return _size == N; }
+
+        void clear()
+        {
+            while (_size > 0)
+            {
+                data()[--_size].~T();
+            }
+        }
+    };
+}
+
+#endif // ! ESP8266_STATIC_VECTOR
@@ -0,0 +1,224 @@
+/**
+ * @file StringView.h
+ * @brief This file contains the implementation of the StringView and Tokenizer classes.
+ * @details This file contains a view over chars owned by someone else, e.g. a payload or a
+ * line of a file, and a tokenizer that splits a view lazily into more views. Neither one
+ * copies nor allocates, so a payload is parsed in place, and numbers are read straight from
+ * the view.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_STRING_VIEW
+#define ESP8266_STRING_VIEW
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <WString.h>
+
+namespace utility
+{
+    class StringView
+    {
+        const char *_data = "";
+        size_t _length = 0;
+
+    public:
+        StringView() = default;
+
+        StringView(const char *text) : _data(text), _length(strlen(text)) {}
+
+        StringView(const char *data, size_t length) : _data(data), _length(length) {}
+
+        StringView(const String &text) : _data(text.c_str()), _length(text.length()) {}
+
+        const char *data() const { return _data; }
+
+        size_t length() const { return _length; }
+
+        bool isEmpty() const { return _length == 0; }
+
+        char operator[](size_t pos) const { return _data[pos]; }
+
+        const char *begin() const { return _data; }
+
+        const char *end() const { return _data + _length; }
+
+        bool equals(StringView other) const
+        {
+            return _length == other._length && memcmp(_data, other._data, _length) == 0;
+        }
+
+        bool operator==(StringView other) const { return equals(other); }
+
+        bool operator!=(StringView other) const { return !equals(other); }
+
+        // Returns the position of the first `c` from `from`, or -1.
+        int indexOf(char c, size_t from = 0) const
+        {
+            for (size_t i = from; i < _length; i++)
+            {
+                if (_data[i] == c)
+                {
+                    return i;
+                }
+            }
+
+            return -1;
+        }
+
+        // Returns the chars from `start` up to `end`, both clamped to the view.
+        StringView substring(size_t start, size_t end = SIZE_MAX) const
+        {
+            end = end < _length ? end : _length;
+            start = start < end ? start : end;
+
+            return StringView(_data + start, end - start);
+        }
+
+        // Returns the view without its leading and trailing whitespace.
+        StringView trim() const
+        {
+            size_t start = 0;
+            size_t end = _length;
+
+            while (start < end && isspace(static_cast<unsigned char>(_data[start])))
+            {
+                start++;
+            }
+
+            while (end > start && isspace(static_cast<unsigned char>(_data[end - 1])))
+            {
+                end--;
+            }
+
+            return StringView(_data + start, end - start);
+        }
+
+        // Splits a pair, e.g. "key=value", on its first `separator`, false if there is none.
+        bool splitPair(char separator, StringView &key, StringView &value) const
+        {
+            auto position = indexOf(separator);
+
+            if (position < 0)
+            {
+                return false;
+            }
+
+            key = substring(0, position);
+            value = substring(position + 1);
+            return true;
+        }
+
+        // Reads a decimal number, false if the view is not one or it overflows.
+        bool toUInt(uint32_t &value) const
+        {
+            if (_length == 0)
+            {
+                return false;
+            }
+
+            uint32_t result = 0;
+
+            for (char c : *this)
+            {
+                if (c < '0' || c > '9' || result > (UINT32_MAX - (c - '0')) / 10)
+                {
+                    return false;
+                }
+
+                result = result * 10 + (c - '0');
+            }
+
+            value = result;
+            return true;
+        }
+
+        // Reads a decimal number with an optional sign, false if the view is not one or it overflows.
+        bool toInt(int32_t &value) const
+        {
+            bool negative = _length > 0 && _data[0] == '-';
+            uint32_t magnitude = 0;
+
+            if (!substring(negative || (_length > 0 && _data[0] == '+')).toUInt(magnitude) ||
+                magnitude > static_cast<uint32_t>(INT32_MAX) + negative)
+            {
+                return false;
+            }
+
+            value = negative ? static_cast<int32_t>(0u - magnitude) : static_cast<int32_t>(magnitude);
+            return true;
+        }
+
+        // Copies the view into a String.
+        String toString() const
+        {
+            String result;
+            result.concat(_data, _length);
+            return result;
+        }
+    };
+
+    // Splits a view on a delimiter, one token per call, skipping empty tokens.
+    class Tokenizer
+    {
+        StringView _text;
+        char _delimiter;
+        size_t _position = 0;
+
+    public:
+        class Iterator
+        {
+            Tokenizer *_tokenizer;
+            StringView _token;
+
+        public:
+            Iterator(Tokenizer *tokenizer) : _tokenizer(tokenizer)
+            {
+                ++*this;
+            }
+            Iterator &operator++()
+            {
+                if (_tokenizer != nullptr && !_tokenizer->next(_token))
+                {
+                    _tokenizer = nullptr;
+                }
+                return *this;
+            }
+            bool operator!=(const Iterator &i) const { return _tokenizer != i._tokenizer; }
+            const StringView &operator*() const { return _token; }
+        };
+
+        Tokenizer(StringView text, char delimiter) : _text(text), _delimiter(delimiter) {}
+
+        // Reads the next token, false once there are no more.
+        bool next(StringView &token)
+        {
+            while (_position < _text.length())
+            {
+                auto end = _text.indexOf(_delimiter, _position);
+                auto stop = end < 0 ? _text.length() : static_cast<size_t>(end);
+
+                token = _text.substring(_position, stop);
+                _position = stop + 1;
+
+                if (!token.isEmpty())
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        Iterator begin() { return Iterator(this); }
+
+        Iterator end() { return Iterator(nullptr); }
+    };
+}
+
+#endif // ! ESP8266_STRING_VIEW
@@ -1,7 +1,8 @@
 /**
  * @file UtilStringArray.h
  * @brief This file contains the implementation of the StringArray class.
- * @details This file contains the implementation of the StringArray class
+ * @details This file contains the implementation of the StringArray class, an array of
+ * strings that keeps its first STRING_ARRAY_INLINE_CAPACITY items inline.
  * @author Higor Grigorio <higorgrigorio@gmail.com>
  * @version 1.0.0
  * @date 2023-07-10
@@ -11,16 +12,18 @@
 #define ESP8266_STRING_ARRAY
 
 #include <WString.h>
-#include <LinkedList.h>
+#include <SmallVector.h>
+
+#ifndef STRING_ARRAY_INLINE_CAPACITY
+#define STRING_ARRAY_INLINE_CAPACITY 8
+#endif // ! STRING_ARRAY_INLINE_CAPACITY
 
 namespace utility
 {
-    class StringArray : public LinkedList<String>
+    class StringArray : public SmallVector<String, STRING_ARRAY_INLINE_CAPACITY>
     {
     public:
-        StringArray() : LinkedList() {}
-
-        bool containsIgnoreCase(const String &str)
+        bool containsIgnoreCase(const String &str) const
         {
             for (const auto &s : *this)
             {
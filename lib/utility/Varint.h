@@ -0,0 +1,166 @@
+/**
+ * @file Varint.h
+ * @brief This file contains the implementation of the variable length integers.
+ * @details This file contains LEB128 unsigned varints, 7 bits per byte with the high bit
+ * set on every byte but the last, and the zig-zag mapping that keeps small negative numbers
+ * short. The writer and the readers never go past their buffer or source and remember any
+ * overflow.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+*/
+#ifndef ESP8266_VARINT
+#define ESP8266_VARINT
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Largest number of bytes of a 32 bits varint.
+ */
+#define VARINT_MAX_SIZE 5
+
+namespace utility
+{
+    // Maps 0, -1, 1, -2... to 0, 1, 2, 3...
+    inline uint32_t zigzagEncode(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    inline int32_t zigzagDecode(uint32_t value)
+    {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    class VarintWriter
+    {
+        uint8_t *_buffer;
+        size_t _capacity;
+        size_t _length = 0;
+        bool _overflow = false;
+
+    public:
+        VarintWriter(uint8_t *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
+        void writeByte(uint8_t value)
+        {
+            if (_length == _capacity)
+            {
+                _overflow = true;
+                return;
+            }
+
+            _buffer[_length++] = value;
+        }
+
+        void write(uint32_t value)
+        {
+            while (value >= 0x80)
+            {
+                writeByte(static_cast<uint8_t>(value) | 0x80);
+                value >>= 7;
+            }
+
+            writeByte(static_cast<uint8_t>(value));
+        }
+
+        void writeSigned(int32_t value)
+        {
+            write(zigzagEncode(value));
+        }
+
+        // Returns the number of bytes written.
+        size_t length() const { return _length; }
+
+        // Checks whether a write did not fit on the buffer.
+        bool overflow() const { return _overflow; }
+    };
+
+    // Reads bytes from a buffer.
+    class BufferSource
+    {
+        const uint8_t *_buffer;
+        size_t _length;
+        size_t _position = 0;
+
+    public:
+        BufferSource(const uint8_t *buffer, size_t length) : _buffer(buffer), _length(length) {}
+
+        bool next(uint8_t &byte)
+        {
+            if (_position == _length)
+            {
+                return false;
+            }
+
+            byte = _buffer[_position++];
+            return true;
+        }
+
+        bool atEnd() const { return _position == _length; }
+    };
+
+    // Reads varints from a source with `bool next(uint8_t &byte)` and `bool atEnd() const`.
+    template <typename Source>
+    class BasicVarintReader
+    {
+        Source _source;
+        bool _malformed = false;
+
+    public:
+        template <typename... Args>
+        BasicVarintReader(Args &&...args) : _source(args...) {}
+
+        uint8_t readByte()
+        {
+            uint8_t byte = 0;
+
+            if (!_source.next(byte))
+            {
+                _malformed = true;
+            }
+
+            return byte;
+        }
+
+        uint32_t read()
+        {
+            uint32_t value = 0;
+
+            for (uint8_t shift = 0; shift < 7 * VARINT_MAX_SIZE; shift += 7)
+            {
+                uint8_t byte = readByte();
+
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80))
+                {
+                    return value;
+                }
+            }
+
+            // more than VARINT_MAX_SIZE bytes.
+            _malformed = true;
+            return value;
+        }
+
+        int32_t readSigned()
+        {
+            return zigzagDecode(read());
+        }
+
+        // Checks whether every byte of the source was read.
+        bool atEnd() const { return _source.atEnd(); }
+
+        // Checks whether a read went past the source or met an invalid varint.
+        bool malformed() const { return _malformed; }
+
+        Source &source() { return _source; }
+    };
+
+    using VarintReader = BasicVarintReader<BufferSource>;
+}
+
+#endif // !ESP8266_VARINT
@@ -11,25 +11,50 @@
 
 // #include <send-measure-to-broker.h>
 #include <read-measure.h>
+#include <measure-log.h>
+#include <rtc-measure-buffer.h>
 
 void setup()
 {
-    Serial.begin(9600);
+    DEBUG_SERIAL.begin(DEBUG_SERIAL_BAUD);
 
     pinMode(LED_BUILTIN, OUTPUT);
     digitalWrite(LED_BUILTIN, LOW);
 
+    BeginSensorBus();
+
     if (!LittleFS.begin())
     {
-        INTERNAL_DEBUG() << "Failed to mount file system";
+        LOG_ERROR(APP) << "Failed to mount file system";
         return;
     }
 
+    auto result4 = CacheDeviceConfig();
+
+    if (!result4.ok())
+    {
+        LOG_ERROR(APP) << result4.error();
+    }
+
+    auto result0 = OpenMeasureLog();
+
+    if (!result0.ok())
+    {
+        LOG_ERROR(APP) << result0.error();
+    }
+
+    auto result3 = RestoreMeasureBuffer();
+
+    if (!result3.ok())
+    {
+        LOG_ERROR(APP) << result3.error();
+    }
+
     auto result1 = SyncWiFi();
 
     if (!result1.ok())
     {
-        INTERNAL_DEBUG() << result1.error();
+        LOG_ERROR(APP) << result1.error();
         return;
     }
 
@@ -37,14 +62,35 @@ void setup()
 
     if (!result2.ok())
     {
-        INTERNAL_DEBUG() << result2.error();
+        LOG_ERROR(APP) << result2.error();
         return;
     }
 
-    INTERNAL_DEBUG() << "Synced successfully";
+    LOG_INFO(APP) << "Synced successfully";
 }
 
 void loop()
 {
+    ScheduleMeasureFromSensor();
+
+    ErrorOr<MeasureBatch> measures;
+
+    if (PollMeasureFromSensor(measures))
+    {
+        if (!measures.ok())
+        {
+            LOG_ERROR(APP) << measures.error();
+        }
+        else
+        {
+            auto result = BufferMeasure(*measures);
+
+            if (!result.ok())
+            {
+                LOG_ERROR(APP) << result.error();
+            }
+        }
+    }
+
     delay(0);
 }
\ No newline at end of file
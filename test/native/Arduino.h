@@ -0,0 +1,62 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in of the Arduino core, for the native tests.
+ * @details Time runs on the host clock, and the pins and the sleeps do nothing.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <HardwareSerial.h>
+#include <WString.h>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define LED_BUILTIN 2
+
+#define PROGMEM
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+inline unsigned long micros()
+{
+    static auto start = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline unsigned long millis() { return micros() / 1000; }
+
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+inline long random(long max) { return rand() % max; }
+
+class EspClass
+{
+public:
+    void restart() { exit(0); }
+    uint32_t getFreeHeap() { return 40000; }
+    uint32_t getCpuFreqMHz() { return 80; }
+    uint32_t getCycleCount() { return micros() * 80; }
+};
+
+inline EspClass ESP;
@@ -0,0 +1,31 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Host stand-in of the UARTs, for the native tests. Output goes to stdout.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include <Stream.h>
+
+#define SERIAL_8N1 0
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    void begin(unsigned long, int) {}
+    void end() {}
+    void swap() {}
+
+    using Print::write;
+    size_t write(uint8_t c) override { return putchar(c) == EOF ? 0 : 1; }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int availableForWrite() { return 128; }
+};
+
+inline HardwareSerial Serial;
+inline HardwareSerial Serial1;
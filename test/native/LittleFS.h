@@ -0,0 +1,201 @@
+/**
+ * @file LittleFS.h
+ * @brief Host stand-in of LittleFS, for the native tests.
+ * @details The files live in memory, shared by every handle, so a write is seen at once by
+ * the other handles. Files opened to append always write at their end, like LittleFS.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File : public Stream
+{
+public:
+    typedef std::vector<uint8_t> Bytes;
+
+    File() = default;
+    File(const std::string &name, std::shared_ptr<Bytes> bytes, size_t position, bool append)
+        : name_(name), bytes_(bytes), position_(position), append_(append) {}
+
+    explicit operator bool() const { return bytes_ != nullptr; }
+
+    using Print::write;
+    size_t write(uint8_t c) override
+    {
+        if (!bytes_)
+        {
+            return 0;
+        }
+
+        if (append_)
+        {
+            position_ = bytes_->size();
+        }
+
+        if (position_ >= bytes_->size())
+        {
+            bytes_->resize(position_ + 1);
+        }
+
+        (*bytes_)[position_++] = c;
+        return 1;
+    }
+
+    int available() override { return bytes_ && position_ < bytes_->size() ? bytes_->size() - position_ : 0; }
+    int read() override { return available() > 0 ? (*bytes_)[position_++] : -1; }
+    int peek() override { return available() > 0 ? (*bytes_)[position_] : -1; }
+
+    size_t read(uint8_t *data, size_t size) { return readBytes(data, size); }
+
+    bool seek(uint32_t position, SeekMode mode = SeekSet)
+    {
+        position += mode == SeekEnd ? size() : mode == SeekCur ? position_ : 0;
+
+        if (position > size())
+        {
+            return false;
+        }
+
+        position_ = position;
+        return true;
+    }
+
+    bool truncate(uint32_t size)
+    {
+        if (!bytes_)
+        {
+            return false;
+        }
+
+        bytes_->resize(size);
+        position_ = position_ < size ? position_ : size;
+        return true;
+    }
+
+    size_t size() const { return bytes_ ? bytes_->size() : 0; }
+    size_t position() const { return position_; }
+    const char *name() const { return name_.c_str(); }
+    const char *fullName() const { return name_.c_str(); }
+    bool isFile() const { return true; }
+
+    void close() { bytes_.reset(); }
+
+private:
+    std::string name_;
+    std::shared_ptr<Bytes> bytes_;
+    size_t position_ = 0;
+    bool append_ = false;
+};
+
+class Dir
+{
+public:
+    explicit Dir(std::vector<std::string> names = {}) : names_(names) {}
+
+    bool next() { return ++index_ < static_cast<int>(names_.size()); }
+    String fileName() const { return String(names_[index_].c_str()); }
+
+private:
+    std::vector<std::string> names_;
+    int index_ = -1;
+};
+
+class FS
+{
+public:
+    bool begin() { return true; }
+    void end() {}
+
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool exists(const char *path) { return files_.count(path) > 0 || isDir(path); }
+
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool mkdir(const char *path)
+    {
+        dirs_.insert(path);
+        return true;
+    }
+
+    File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+    File open(const char *path, const char *mode)
+    {
+        auto &bytes = files_[path];
+
+        if (mode[0] == 'r' && !bytes)
+        {
+            files_.erase(path);
+            return File();
+        }
+
+        if (!bytes || mode[0] == 'w')
+        {
+            bytes = std::make_shared<File::Bytes>();
+        }
+
+        return File(path, bytes, mode[0] == 'a' ? bytes->size() : 0, mode[0] == 'a');
+    }
+
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool remove(const char *path) { return files_.erase(path) > 0; }
+
+    bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    bool rename(const char *from, const char *to)
+    {
+        auto file = files_.find(from);
+
+        if (file == files_.end())
+        {
+            return false;
+        }
+
+        files_[to] = file->second;
+        files_.erase(from);
+        return true;
+    }
+
+    Dir openDir(const String &path) { return openDir(path.c_str()); }
+    Dir openDir(const char *path)
+    {
+        std::string prefix = std::string(path) + "/";
+        std::vector<std::string> names;
+
+        for (auto &file : files_)
+        {
+            if (file.first.compare(0, prefix.size(), prefix) == 0)
+            {
+                names.push_back(file.first.substr(prefix.size()));
+            }
+        }
+
+        return Dir(names);
+    }
+
+    // Drops every file, e.g. between two tests.
+    void format()
+    {
+        files_.clear();
+        dirs_.clear();
+    }
+
+private:
+    bool isDir(const std::string &path) const { return dirs_.count(path) > 0; }
+
+    std::map<std::string, std::shared_ptr<File::Bytes>> files_;
+    std::set<std::string> dirs_;
+};
+
+inline FS LittleFS;
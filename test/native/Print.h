@@ -0,0 +1,43 @@
+/**
+ * @file Print.h
+ * @brief Host stand-in of the Arduino Print, for the native tests.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <WString.h>
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t *data, size_t size)
+    {
+        size_t written = 0;
+
+        while (size-- > 0)
+        {
+            written += write(*data++);
+        }
+
+        return written;
+    }
+
+    virtual void flush() {}
+
+    size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.length()); }
+    size_t print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    size_t print(const __FlashStringHelper *text) { return print(reinterpret_cast<const char *>(text)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    template <typename T>
+    size_t print(T value, int base = DEC) { return print(String(value, base)); }
+
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+};
@@ -0,0 +1,10 @@
+/**
+ * @file Printable.h
+ * @brief Host stand-in of the Arduino Printable, for the native tests.
+ */
+
+#pragma once
+
+class Printable
+{
+};
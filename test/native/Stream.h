@@ -0,0 +1,30 @@
+/**
+ * @file Stream.h
+ * @brief Host stand-in of the Arduino Stream, for the native tests.
+ */
+
+#pragma once
+
+#include <Print.h>
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+
+    size_t readBytes(uint8_t *data, size_t size)
+    {
+        size_t length = 0;
+
+        while (length < size && available() > 0)
+        {
+            data[length++] = read();
+        }
+
+        return length;
+    }
+
+    size_t readBytes(char *data, size_t size) { return readBytes(reinterpret_cast<uint8_t *>(data), size); }
+};
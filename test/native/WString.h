@@ -0,0 +1,110 @@
+/**
+ * @file WString.h
+ * @brief Host stand-in of the Arduino String, for the native tests.
+ * @details Only the members the firmware calls, over a std::string.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <string>
+
+class __FlashStringHelper;
+
+#define F(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+#define PSTR(text) (text)
+
+#define DEC 10
+#define HEX 16
+
+class String
+{
+public:
+    String() = default;
+    String(const char *text) : text_(text != nullptr ? text : "") {}
+    String(const __FlashStringHelper *text) : text_(reinterpret_cast<const char *>(text)) {}
+    explicit String(char c) : text_(1, c) {}
+    String(int value, unsigned char base = DEC) : String(static_cast<long>(value), base) {}
+    String(unsigned int value, unsigned char base = DEC) : String(static_cast<unsigned long>(value), base) {}
+    String(long value, unsigned char base = DEC) { format(base == HEX ? "%lx" : "%ld", value); }
+    String(unsigned long value, unsigned char base = DEC) { format(base == HEX ? "%lx" : "%lu", value); }
+    String(double value, unsigned char decimals = 2) { format("%.*f", decimals, value); }
+
+    unsigned int length() const { return text_.size(); }
+    const char *c_str() const { return text_.c_str(); }
+    bool reserve(unsigned int size) { text_.reserve(size); return true; }
+    void clear() { text_.clear(); }
+
+    bool concat(const String &text) { text_ += text.text_; return true; }
+    bool concat(const char *text) { text_ += text; return true; }
+    bool concat(const char *text, unsigned int length) { text_.append(text, length); return true; }
+    bool concat(char c) { text_ += c; return true; }
+    template <typename T>
+    bool concat(T value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(T value) { concat(value); return *this; }
+
+    String substring(unsigned int start, unsigned int end = UINT32_MAX) const
+    {
+        end = end < text_.size() ? end : text_.size();
+        return start < end ? String(text_.substr(start, end - start).c_str()) : String();
+    }
+
+    bool equals(const String &text) const { return text_ == text.text_; }
+    bool equalsIgnoreCase(const String &text) const { return strcasecmp(c_str(), text.c_str()) == 0; }
+    bool operator==(const String &text) const { return equals(text); }
+    bool operator==(const char *text) const { return text_ == text; }
+    bool operator!=(const String &text) const { return !equals(text); }
+    bool operator!=(const char *text) const { return text_ != text; }
+
+    char operator[](unsigned int pos) const { return text_[pos]; }
+    char &operator[](unsigned int pos) { return text_[pos]; }
+    const char *begin() const { return text_.data(); }
+    const char *end() const { return text_.data() + text_.size(); }
+
+    long toInt() const { return atol(c_str()); }
+
+    int indexOf(char c) const
+    {
+        auto pos = text_.find(c);
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+
+    void trim()
+    {
+        auto start = text_.find_first_not_of(" \t\r\n");
+        text_ = start == std::string::npos ? "" : text_.substr(start, text_.find_last_not_of(" \t\r\n") - start + 1);
+    }
+
+private:
+    template <typename... Args>
+    void format(const char *spec, Args... args)
+    {
+        char buffer[34];
+        snprintf(buffer, sizeof(buffer), spec, args...);
+        text_ = buffer;
+    }
+
+    std::string text_;
+};
+
+template <typename T>
+inline String operator+(const String &left, T right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+
+inline String operator+(const char *left, const String &right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
@@ -0,0 +1,8 @@
+/**
+ * @file c_types.h
+ * @brief Host stand-in of the SDK integer types, for the native tests.
+ */
+
+#pragma once
+
+#include <stdint.h>
@@ -0,0 +1,72 @@
+/**
+ * @file ram-flash.h
+ * @brief A flash in RAM, for the native tests of the flash ring.
+ * @details The flash of the ESP8266 on the host, with the interface of SpiFlash: erasing
+ * sets the bytes of a sector to 0xFF, and writing only clears bits, so a torn or repeated
+ * write leaves what the real flash would. Writes must be 4 bytes aligned, like on the
+ * SDK. Every instance shares the same bytes, so a store opened again sees what the last
+ * one left, like after a reboot, and reset() erases them.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef RAM_FLASH_SECTORS
+#define RAM_FLASH_SECTORS 32
+#endif // ! RAM_FLASH_SECTORS
+
+class RamFlash
+{
+public:
+    static constexpr uint32_t SECTOR_SIZE = 4096;
+
+    auto read(uint32_t address, void *data, size_t size) -> bool
+    {
+        if (address + size > sizeof(bytes_))
+        {
+            return false;
+        }
+
+        memcpy(data, bytes_ + address, size);
+        return true;
+    }
+
+    auto write(uint32_t address, const void *data, size_t size) -> bool
+    {
+        if (address % 4 != 0 || size % 4 != 0 || address + size > sizeof(bytes_))
+        {
+            return false;
+        }
+
+        auto in = static_cast<const uint8_t *>(data);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            bytes_[address + i] &= in[i];
+        }
+
+        return true;
+    }
+
+    auto erase(uint32_t address) -> bool
+    {
+        if (address % SECTOR_SIZE != 0 || address >= sizeof(bytes_))
+        {
+            return false;
+        }
+
+        memset(bytes_ + address, 0xFF, SECTOR_SIZE);
+        return true;
+    }
+
+    // Erases the whole flash, e.g. between two tests.
+    static auto reset() -> void
+    {
+        memset(bytes_, 0xFF, sizeof(bytes_));
+    }
+
+private:
+    static inline uint8_t bytes_[RAM_FLASH_SECTORS * SECTOR_SIZE];
+};
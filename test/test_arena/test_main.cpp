@@ -0,0 +1,71 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests of the arena the broker messages are handled on
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sensor-self.h>
+#include <sensor-typing.h>
+
+TEST(ArenaTest, ScopeFreesEverythingAtOnce)
+{
+    utility::StaticArena<64> arena;
+
+    arena.copy("kept", 4);
+
+    {
+        utility::ArenaScope scope(arena);
+
+        ASSERT_NE(arena.format("%s-%d", "scoped", 42), nullptr);
+        EXPECT_GT(arena.used(), 5u);
+    }
+
+    EXPECT_EQ(arena.used(), 5u);
+    EXPECT_GT(arena.highWater(), 5u);
+}
+
+TEST(ArenaTest, FailsWhenFull)
+{
+    utility::StaticArena<8> arena;
+
+    EXPECT_EQ(arena.format("%s", "longer than the arena"), nullptr);
+    EXPECT_STREQ(arena.copy("1234567", 7), "1234567");
+    EXPECT_EQ(arena.copy("x", 1), nullptr);
+}
+
+TEST(ArenaTest, HoldsTheTextsOfAPayload)
+{
+    utility::StaticArena<128> arena;
+    char payload[] = "success=true;ph=abc;2:nitrogen=def";
+
+    auto credentials = CredentialsFromBrokerPayload(payload, sizeof(payload) - 1, arena);
+
+    ASSERT_TRUE(credentials.ok());
+    ASSERT_EQ(credentials->length(), 2u);
+
+    // the payload buffer is reused by the client once the message is handled.
+    memset(payload, 0, sizeof(payload));
+
+    EXPECT_STREQ((*credentials)[1].key, "2:nitrogen");
+    EXPECT_STREQ((*credentials)[1].id, "def");
+}
+
+TEST(ArenaTest, FailsAPayloadLargerThanTheArena)
+{
+    utility::StaticArena<8> arena;
+    const char payload[] = "success=true;id=0123456789";
+
+    EXPECT_FALSE(SelfFromBrokerPayload(payload, sizeof(payload) - 1, arena).ok());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
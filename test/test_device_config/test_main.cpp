@@ -0,0 +1,132 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests of the configuration record of the device
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <device-config.h>
+
+#include <vector>
+
+class DeviceConfigTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        fileHandles.closeAll();
+        LittleFS.format();
+
+        strcpy(config_.ssid, "naturart");
+        strcpy(config_.self, "self-id");
+    }
+
+    // Writes a record of `size` bytes of configuration, the known fields first, then `padding`
+    // bytes past it.
+    auto writeRecord(uint16_t size, bool corrupt = false, size_t padding = 0) -> void
+    {
+        std::vector<uint8_t> body(size, 0xA5);
+
+        memcpy(body.data(), &config_, size < sizeof(config_) ? size : sizeof(config_));
+
+        DeviceConfigHeader header = {
+            .magic = DEVICE_CONFIG_MAGIC,
+            .version = DEVICE_CONFIG_VERSION,
+            .size = size,
+            .crc = 0,
+        };
+
+        header.crc = DeviceConfigChecksum(header, body.data(), size);
+
+        if (corrupt)
+        {
+            body.back() ^= 0xFF;
+        }
+
+        File file = LittleFS.open(DEVICE_CONFIG_FILE, "w");
+
+        file.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+        file.write(body.data(), body.size());
+
+        for (size_t i = 0; i < padding; i++)
+        {
+            file.write(0);
+        }
+
+        file.close();
+    }
+
+    DeviceConfig config_{};
+};
+
+TEST_F(DeviceConfigTest, LoadsTheSavedRecord)
+{
+    ASSERT_TRUE(SaveDeviceConfig(config_).ok());
+
+    DeviceConfig config;
+
+    ASSERT_TRUE(LoadDeviceConfig(config).ok());
+    EXPECT_STREQ(config.ssid, "naturart");
+    EXPECT_STREQ(config.self, "self-id");
+}
+
+TEST_F(DeviceConfigTest, LoadsARecordFollowedByPadding)
+{
+    writeRecord(sizeof(DeviceConfig), false, 3);
+
+    DeviceConfig config;
+
+    ASSERT_TRUE(LoadDeviceConfig(config).ok());
+    EXPECT_STREQ(config.self, "self-id");
+}
+
+TEST_F(DeviceConfigTest, LoadsAnOlderRecord)
+{
+    writeRecord(offsetof(DeviceConfig, typesLength));
+
+    DeviceConfig config;
+
+    ASSERT_TRUE(LoadDeviceConfig(config).ok());
+    EXPECT_STREQ(config.self, "self-id");
+    EXPECT_EQ(config.typesLength, 0);
+}
+
+TEST_F(DeviceConfigTest, LoadsTheKnownFieldsOfANewerRecord)
+{
+    writeRecord(sizeof(DeviceConfig) + 100);
+
+    DeviceConfig config;
+
+    ASSERT_TRUE(LoadDeviceConfig(config).ok());
+    EXPECT_STREQ(config.self, "self-id");
+}
+
+TEST_F(DeviceConfigTest, RejectsANewerRecordWithACorruptTail)
+{
+    writeRecord(sizeof(DeviceConfig) + 100, true);
+
+    DeviceConfig config;
+
+    EXPECT_FALSE(LoadDeviceConfig(config).ok());
+    EXPECT_STREQ(config.self, "");
+}
+
+TEST_F(DeviceConfigTest, RejectsACorruptRecord)
+{
+    writeRecord(sizeof(DeviceConfig), true);
+
+    DeviceConfig config;
+
+    EXPECT_FALSE(LoadDeviceConfig(config).ok());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests of the filter of the sensor readings
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <measure-filter.h>
+
+#include <initializer_list>
+
+TEST(MeasureFilterTest, DiscardedReadingsDoNotReachTheNextMeasure)
+{
+    MeasureFilter filter;
+    MeasureFilter fresh;
+
+    for (int i = 0; i < MEASURE_OVERSAMPLING; i++)
+    {
+        filter.add(5000);
+    }
+
+    filter.discard();
+
+    for (int32_t raw : {100, 104, 98, 102})
+    {
+        filter.add(raw);
+        fresh.add(raw);
+    }
+
+    EXPECT_FALSE(filter.primed());
+    EXPECT_EQ(filter.take(), fresh.take());
+}
+
+TEST(MeasureFilterTest, TakenReadingsDoNotReachTheNextMeasure)
+{
+    MeasureFilter filter;
+    MeasureFilter other;
+
+    // both measures are 100, from different readings.
+    for (int32_t raw : {100, 100, 100, 5000})
+    {
+        filter.add(raw);
+    }
+
+    for (int32_t raw : {100, 100, 100, 100})
+    {
+        other.add(raw);
+    }
+
+    EXPECT_EQ(filter.take(), other.take());
+
+    for (int32_t raw : {10, 12, 11, 10})
+    {
+        filter.add(raw);
+        other.add(raw);
+    }
+
+    EXPECT_EQ(filter.take(), other.take());
+}
+
+// Takes a measure of a fresh filter from MEASURE_OVERSAMPLING readings.
+auto Filter(std::initializer_list<int32_t> readings) -> int32_t
+{
+    MeasureFilter filter;
+
+    for (auto raw : readings)
+    {
+        filter.add(raw);
+    }
+
+    return filter.take();
+}
+
+TEST(MeasureFilterTest, RejectsASpike)
+{
+    EXPECT_EQ(Filter({100, 100, 900, 100}), 100);
+}
+
+TEST(MeasureFilterTest, RejectsASpikeOnTheFirstReading)
+{
+    EXPECT_EQ(Filter({900, 100, 100, 100}), 100);
+}
+
+TEST(MeasureFilterTest, RejectsALowSpikeOnTheSecondReading)
+{
+    EXPECT_EQ(Filter({100, -500, 100, 100}), 100);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,358 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests of the measure log on each segment store
+ * @details Every test runs on the files of LittleFS and on the flash ring, both in RAM.
+ * @author Higor Grigorio <higorgrigorio@gmail.com>
+ * @version 1.0.0
+ * @date 2023-07-10
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <measure-log.h>
+#include <ram-flash.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Measures taken on a round over the 6 registers.
+ */
+#define TEST_BLOCK_LENGTH 6
+
+struct LittleFsBackend
+{
+    typedef LittleFsSegmentStore Store;
+
+    static auto make() -> std::unique_ptr<BasicMeasureLog<Store>>
+    {
+        return std::unique_ptr<BasicMeasureLog<Store>>(new BasicMeasureLog<Store>());
+    }
+};
+
+struct FlashRingBackend
+{
+    typedef FlashRingSegmentStore<RamFlash> Store;
+
+    static auto make() -> std::unique_ptr<BasicMeasureLog<Store>>
+    {
+        return std::unique_ptr<BasicMeasureLog<Store>>(new BasicMeasureLog<Store>(0));
+    }
+};
+
+template <typename Backend>
+class MeasureStoreTest : public testing::Test
+{
+protected:
+    typedef typename Backend::Store Store;
+    typedef BasicMeasureLog<Store> Log;
+
+    void SetUp() override
+    {
+        fileHandles.closeAll();
+        LittleFS.format();
+        RamFlash::reset();
+
+        log_ = reopen();
+    }
+
+    // Opens the log again, as after a reboot.
+    auto reopen() -> std::unique_ptr<Log>
+    {
+        auto log = Backend::make();
+
+        EXPECT_TRUE(log->open().ok());
+
+        return log;
+    }
+
+    // Appends the block of measures number `block` and returns the segment it went to.
+    auto append(Log &log, uint32_t block) -> uint32_t
+    {
+        Measure measures[TEST_BLOCK_LENGTH];
+
+        for (uint8_t type = 0; type < TEST_BLOCK_LENGTH; type++)
+        {
+            measures[type] = {
+                .timestamp = 1700000000 + block * 60,
+                .value = static_cast<int32_t>(block * 7 + type),
+                .parameter = SOIL_REGISTERS[type].parameter,
+                .flags = 0,
+                .type = type,
+                .slave = 1,
+            };
+        }
+
+        EXPECT_TRUE(log.append(measures, TEST_BLOCK_LENGTH).ok());
+
+        log.sync();
+
+        return log.head().segment;
+    }
+
+    // Reads the log from its first undelivered measure and returns the blocks read.
+    auto readBack(Log &log) -> std::vector<uint32_t>
+    {
+        BasicMeasureCursor<Store> cursor(log);
+        std::vector<uint32_t> blocks;
+        Measure measure;
+
+        for (uint32_t index = 0; cursor.next(measure); index++)
+        {
+            uint32_t block = (measure.timestamp - 1700000000) / 60;
+
+            EXPECT_EQ(measure.type, index % TEST_BLOCK_LENGTH);
+            EXPECT_EQ(measure.value, static_cast<int32_t>(block * 7 + measure.type));
+
+            if (measure.type == 0)
+            {
+                blocks.push_back(block);
+            }
+        }
+
+        return blocks;
+    }
+
+    // Writes the start of a block that a power loss cut short.
+    auto tear(Log &log, uint32_t segment, uint32_t offset) -> void
+    {
+        uint8_t torn[16];
+
+        MeasureLogBlockHeader header = {
+            .magic = MEASURE_LOG_BLOCK_MAGIC,
+            .count = TEST_BLOCK_LENGTH,
+            .size = 64,
+            .crc = 0xDEADBEEF,
+        };
+
+        memset(torn, 0x5A, sizeof(torn));
+        memcpy(torn, &header, sizeof(header));
+
+        ASSERT_TRUE(log.store().write(segment, offset, torn, sizeof(torn)));
+
+        log.store().sync();
+    }
+
+    // Checks the log appends where the torn block was, or on a new segment when the store
+    // cannot drop the torn block.
+    static auto expectRecovered(Log &log, const MeasureLogPosition &torn) -> void
+    {
+        EXPECT_EQ(log.head().segment, torn.segment);
+        EXPECT_TRUE(log.head().offset == torn.offset || log.head().offset == Store::SEGMENT_SIZE);
+    }
+
+    static auto sequence(uint32_t first, uint32_t last) -> std::vector<uint32_t>
+    {
+        std::vector<uint32_t> blocks;
+
+        for (auto block = first; block < last; block++)
+        {
+            blocks.push_back(block);
+        }
+
+        return blocks;
+    }
+
+    std::unique_ptr<Log> log_;
+};
+
+typedef testing::Types<LittleFsBackend, FlashRingBackend> Backends;
+
+TYPED_TEST_SUITE(MeasureStoreTest, Backends);
+
+TYPED_TEST(MeasureStoreTest, ReadsBackTheAppendedBlocks)
+{
+    uint32_t blocks = 0;
+
+    while (this->append(*this->log_, blocks++) < 3)
+    {
+    }
+
+    EXPECT_EQ(this->readBack(*this->log_), this->sequence(0, blocks));
+
+    auto head = this->log_->head();
+    auto log = this->reopen();
+
+    EXPECT_EQ(log->first(), 1u);
+    EXPECT_EQ(log->head().segment, head.segment);
+    EXPECT_EQ(log->head().offset, head.offset);
+    EXPECT_EQ(this->readBack(*log), this->sequence(0, blocks));
+}
+
+TYPED_TEST(MeasureStoreTest, DropsATornLastRecord)
+{
+    for (uint32_t block = 0; block < 10; block++)
+    {
+        this->append(*this->log_, block);
+    }
+
+    auto head = this->log_->head();
+
+    this->tear(*this->log_, head.segment, head.offset);
+
+    auto log = this->reopen();
+
+    this->expectRecovered(*log, head);
+
+    EXPECT_EQ(this->readBack(*log), this->sequence(0, 10));
+
+    this->append(*log, 10);
+
+    EXPECT_EQ(this->readBack(*log), this->sequence(0, 11));
+    EXPECT_EQ(this->readBack(*this->reopen()), this->sequence(0, 11));
+}
+
+TYPED_TEST(MeasureStoreTest, DropsATornLastSegment)
+{
+    for (uint32_t block = 0; block < 10; block++)
+    {
+        this->append(*this->log_, block);
+    }
+
+    auto head = this->log_->head();
+
+    this->tear(*this->log_, head.segment + 1, 0);
+
+    auto log = this->reopen();
+
+    this->expectRecovered(*log, {.segment = head.segment + 1});
+
+    EXPECT_EQ(this->readBack(*log), this->sequence(0, 10));
+
+    EXPECT_GT(this->append(*log, 10), head.segment);
+
+    EXPECT_EQ(this->readBack(*log), this->sequence(0, 11));
+    EXPECT_EQ(this->readBack(*this->reopen()), this->sequence(0, 11));
+}
+
+TYPED_TEST(MeasureStoreTest, WrapsAroundTheRing)
+{
+    std::vector<uint32_t> segments;
+
+    while (segments.empty() || segments.back() < 2 * MEASURE_LOG_MAX_SEGMENTS + 3)
+    {
+        segments.push_back(this->append(*this->log_, segments.size()));
+    }
+
+    auto last = segments.back();
+    auto first = last - MEASURE_LOG_MAX_SEGMENTS + 1;
+
+    EXPECT_EQ(this->log_->first(), first);
+    EXPECT_EQ(this->log_->lost(), first - 1);
+
+    // the blocks of the segments dropped are lost.
+    uint32_t kept = 0;
+
+    while (segments[kept] < first)
+    {
+        kept++;
+    }
+
+    EXPECT_EQ(this->readBack(*this->log_), this->sequence(kept, segments.size()));
+
+    auto log = this->reopen();
+
+    EXPECT_EQ(log->first(), first);
+    EXPECT_EQ(log->head().segment, last);
+    EXPECT_EQ(this->readBack(*log), this->sequence(kept, segments.size()));
+
+    uint32_t found[2];
+
+    ASSERT_TRUE(log->store().segments(found[0], found[1]));
+    EXPECT_EQ(found[0], first);
+    EXPECT_EQ(found[1], last);
+}
+
+TYPED_TEST(MeasureStoreTest, RemovesTheAcknowledgedSegments)
+{
+    std::vector<uint32_t> segments;
+
+    while (segments.empty() || segments.back() < 4)
+    {
+        segments.push_back(this->append(*this->log_, segments.size()));
+    }
+
+    uint32_t delivered = 0;
+
+    while (segments[delivered] < 3)
+    {
+        delivered++;
+    }
+
+    ASSERT_TRUE(this->log_->acknowledge({.segment = 3}).ok());
+
+    EXPECT_EQ(this->log_->first(), 3u);
+    EXPECT_EQ(this->readBack(*this->log_), this->sequence(delivered, segments.size()));
+
+    uint32_t found[2];
+
+    ASSERT_TRUE(this->log_->store().segments(found[0], found[1]));
+    EXPECT_EQ(found[0], 3u);
+    EXPECT_EQ(found[1], segments.back());
+
+    auto log = this->reopen();
+
+    EXPECT_EQ(log->first(), 3u);
+    EXPECT_EQ(log->acknowledged().segment, 3u);
+    EXPECT_EQ(this->readBack(*log), this->sequence(delivered, segments.size()));
+}
+
+TEST(ImportMeasureFileTest, MovesTheLegacyFileToTheLog)
+{
+    fileHandles.closeAll();
+    LittleFS.format();
+
+    File file = LittleFS.open(MEASURE_FILE, "w");
+
+    for (uint32_t line = 0; line < 2 * MEASURE_BLOCK_CAPACITY + 3; line++)
+    {
+        file.print(String(line) + ".5;" + SOIL_REGISTERS[0].type + ";1;" + (1700000000 + line) + ";0\n");
+    }
+
+    file.close();
+
+    ASSERT_TRUE(OpenMeasureLog().ok());
+    EXPECT_FALSE(FileExists(MEASURE_FILE));
+
+    MeasureCursor cursor(measureLog);
+    Measure measure;
+    uint32_t line = 0;
+
+    while (cursor.next(measure))
+    {
+        EXPECT_EQ(measure.timestamp, 1700000000 + line);
+        line++;
+    }
+
+    EXPECT_EQ(line, 2 * MEASURE_BLOCK_CAPACITY + 3);
+}
+
+TEST(ImportMeasureFileTest, SkipsALineWithAnAddressLargerThanAByte)
+{
+    fileHandles.closeAll();
+    LittleFS.format();
+
+    File file = LittleFS.open(MEASURE_FILE, "w");
+
+    file.print(String("1.5;") + SOIL_REGISTERS[0].type + ";300;1700000000;0\n");
+    file.print(String("2.5;") + SOIL_REGISTERS[0].type + ";2;1700000001;0\n");
+    file.close();
+
+    ASSERT_TRUE(OpenMeasureLog().ok());
+
+    MeasureCursor cursor(measureLog);
+    Measure measure;
+
+    ASSERT_TRUE(cursor.next(measure));
+    EXPECT_EQ(measure.slave, 2);
+    EXPECT_EQ(measure.timestamp, 1700000001u);
+    EXPECT_FALSE(cursor.next(measure));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}